@@ -0,0 +1,355 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "policy.h"
+
+/**
+ * @brief Map an algorithm name ("rr", "hpf", "srtn", "edf", "rm", "lottery", "stride", "sjf", "hrrn") to its enum value
+ *
+ * @return int 0 for success, 1 for an unknown name
+ */
+int parse_algorithm(const char* name, SchedulingAlgorithm* algorithm) {
+    if (strcmp(name, "rr") == 0) {
+        *algorithm = RR;
+    }
+    else if (strcmp(name, "hpf") == 0) {
+        *algorithm = HPF;
+    }
+    else if (strcmp(name, "srtn") == 0) {
+        *algorithm = SRTN;
+    }
+    else if (strcmp(name, "edf") == 0) {
+        *algorithm = EDF;
+    }
+    else if (strcmp(name, "rm") == 0) {
+        *algorithm = RM;
+    }
+    else if (strcmp(name, "lottery") == 0) {
+        *algorithm = LOTTERY;
+    }
+    else if (strcmp(name, "stride") == 0) {
+        *algorithm = STRIDE;
+    }
+    else if (strcmp(name, "sjf") == 0) {
+        *algorithm = SJF;
+    }
+    else if (strcmp(name, "hrrn") == 0) {
+        *algorithm = HRRN;
+    }
+    else {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Short name of an algorithm, as accepted by parse_algorithm
+ */
+const char* algorithm_name(SchedulingAlgorithm algorithm) {
+    switch (algorithm) {
+    case RR:
+        return "rr";
+    case HPF:
+        return "hpf";
+    case SRTN:
+        return "srtn";
+    case EDF:
+        return "edf";
+    case RM:
+        return "rm";
+    case LOTTERY:
+        return "lottery";
+    case STRIDE:
+        return "stride";
+    case SJF:
+        return "sjf";
+    case HRRN:
+        return "hrrn";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Burst length the scheduler believes a process has: the prediction when runtime
+ *        prediction is on, the true runtime otherwise
+ */
+static int policy_burst(PCB* pcb) {
+    return pcb->predicted_runtime > 0 ? pcb->predicted_runtime : pcb->PDATA.runtime;
+}
+
+/**
+ * @brief Remaining time the scheduler believes a process has (an underestimated burst stays at 0)
+ */
+static int policy_remaining(PCB* pcb) {
+    if (pcb->predicted_runtime <= 0) {
+        return pcb->remaining_time;
+    }
+    int remaining = pcb->predicted_runtime - (pcb->PDATA.runtime - pcb->remaining_time);
+    return remaining > 0 ? remaining : 0;
+}
+
+/**
+ * @brief Ready queue priority of a process (lower runs first, except for the lottery
+ *        queue where it is the process's ticket count and the HRRN kinetic queue where it
+ *        packs the arrival time (high 32 bits) and the service time (low 32 bits))
+ */
+long long policy_priority(SchedulingAlgorithm algorithm, PCB* pcb) {
+    switch (algorithm) {
+    case SRTN:
+        return policy_remaining(pcb);
+    case HPF:
+        return pcb->PDATA.priority;
+    case EDF:
+        return pcb->PDATA.deadline > 0 ? pcb->PDATA.deadline : INT_MAX; // no deadline runs in the background
+    case RM:
+        return pcb->PDATA.period > 0 ? pcb->PDATA.period : INT_MAX; // aperiodic processes run in the background
+    case LOTTERY:
+        return policy_tickets(pcb);
+    case STRIDE:
+        return pcb->pass;
+    case SJF:
+        return policy_burst(pcb);
+    case HRRN:
+        return ((long long)pcb->PDATA.arrival_time << 32) | (unsigned int)policy_burst(pcb);
+    case RR:
+    default:
+        return 0; // RR doesn't use priority
+    }
+}
+
+/**
+ * @brief Ready queue key of a process, with HPF aging when `aging_interval` > 0
+ * @details Aging improves a waiting process's priority by one level every `aging_interval`
+ *          ticks since its arrival, so at time t its effective priority is
+ *          priority - (t - arrival) / interval. Comparing two effective priorities at the same t
+ *          is the same as comparing priority * interval + arrival, which does not depend on t:
+ *          the key is computed once at enqueue and no queued entry is ever touched again.
+ *          A process of priority p waits at most about p * interval ticks behind later arrivals.
+ */
+long long policy_queue_key(SchedulingAlgorithm algorithm, int aging_interval, PCB* pcb) {
+    if (algorithm != HPF || aging_interval <= 0) {
+        return policy_priority(algorithm, pcb);
+    }
+
+    return (long long)pcb->PDATA.priority * aging_interval + pcb->PDATA.arrival_time;
+}
+
+/**
+ * @brief Whether a newly ready process can preempt the running one
+ */
+int policy_is_preemptive(SchedulingAlgorithm algorithm) {
+    return algorithm == SRTN || algorithm == EDF || algorithm == RM;
+}
+
+/**
+ * @brief Whether the dispatched process leaves the ready queue and keeps the CPU until it finishes
+ */
+int policy_runs_to_completion(SchedulingAlgorithm algorithm) {
+    return algorithm == HPF || algorithm == SJF || algorithm == HRRN;
+}
+
+/**
+ * @brief Whether the algorithm orders processes by burst length (and can use runtime prediction)
+ */
+int policy_uses_burst(SchedulingAlgorithm algorithm) {
+    return algorithm == SRTN || algorithm == SJF || algorithm == HRRN;
+}
+
+/**
+ * @brief Whether `next` (front of the ready queue) should preempt `running`
+ */
+int policy_should_preempt(SchedulingAlgorithm algorithm, PCB* running, PCB* next) {
+    if (!policy_is_preemptive(algorithm) || running == NULL || next == NULL || running == next) {
+        return 0;
+    }
+    return policy_priority(algorithm, next) < policy_priority(algorithm, running);
+}
+
+/**
+ * @brief Whether the quantum changes the algorithm's schedule
+ */
+int policy_uses_quantum(SchedulingAlgorithm algorithm) {
+    return algorithm == RR || algorithm == LOTTERY || algorithm == STRIDE;
+}
+
+/**
+ * @brief Whether the algorithm shares the CPU in proportion to tickets
+ */
+int policy_is_proportional_share(SchedulingAlgorithm algorithm) {
+    return algorithm == LOTTERY || algorithm == STRIDE;
+}
+
+/**
+ * @brief Tickets of a process: SHARE_TICKET_LEVELS for priority 0 down to one for priority 10 and above
+ */
+int policy_tickets(PCB* pcb) {
+    int priority = pcb->PDATA.priority;
+    if (priority < 0) {
+        priority = 0;
+    }
+    if (priority > SHARE_TICKET_LEVELS - 1) {
+        priority = SHARE_TICKET_LEVELS - 1;
+    }
+    return SHARE_TICKET_LEVELS - priority;
+}
+
+/**
+ * @brief Charge `ran` ticks of CPU to a process that is coming off the CPU
+ * @details Stride advances the process's pass by its stride (STRIDE_UNIT / tickets) per tick,
+ *          so processes holding more tickets come due again sooner.
+ */
+void policy_charge(SchedulingAlgorithm algorithm, PCB* pcb, int ran) {
+    if (algorithm == STRIDE) {
+        pcb->pass += (long long)ran * (STRIDE_UNIT / policy_tickets(pcb));
+    }
+}
+
+void share_clock_init(ShareClock* clock, int now) {
+    clock->virtual_time = 0;
+    clock->tickets = 0;
+    clock->updated_at = now;
+    clock->pass = 0;
+}
+
+/**
+ * @brief Advance the fair share clock to `now`: every tick is split among the tickets held
+ */
+static void share_clock_advance(ShareClock* clock, int now) {
+    if (clock->tickets > 0 && now > clock->updated_at) {
+        clock->virtual_time += (double)(now - clock->updated_at) / clock->tickets;
+    }
+    clock->updated_at = now;
+}
+
+/**
+ * @brief A process became ready (arrived or back from I/O): start its entitlement, its stride
+ *        pass is at least the global pass so time spent away earns no credit
+ */
+void share_clock_join(ShareClock* clock, PCB* pcb, int now) {
+    share_clock_advance(clock, now);
+    pcb->share_start = clock->virtual_time;
+    if (pcb->pass < clock->pass) {
+        pcb->pass = clock->pass;
+    }
+    clock->tickets += policy_tickets(pcb);
+}
+
+/**
+ * @brief A process was dispatched: its pass is the lowest, so it becomes the global pass
+ */
+void share_clock_dispatch(ShareClock* clock, PCB* pcb) {
+    if (pcb->pass > clock->pass) {
+        clock->pass = pcb->pass;
+    }
+}
+
+/**
+ * @brief A process finished or blocked: add the CPU time it was entitled to since it
+ *        joined to intended_service
+ */
+void share_clock_leave(ShareClock* clock, PCB* pcb, int now) {
+    share_clock_advance(clock, now);
+    int tickets = policy_tickets(pcb);
+    pcb->intended_service += tickets * (clock->virtual_time - pcb->share_start);
+    clock->tickets -= tickets;
+}
+
+/**
+ * @brief Map an admission mode name ("off", "flag", "reject") to its enum value
+ *
+ * @return int 0 for success, 1 for an unknown name
+ */
+int parse_admission(const char* name, AdmissionMode* mode) {
+    if (strcmp(name, "off") == 0) {
+        *mode = ADMISSION_OFF;
+    }
+    else if (strcmp(name, "flag") == 0) {
+        *mode = ADMISSION_FLAG;
+    }
+    else if (strcmp(name, "reject") == 0) {
+        *mode = ADMISSION_REJECT;
+    }
+    else {
+        return 1;
+    }
+    return 0;
+}
+
+const char* admission_name(AdmissionMode mode) {
+    switch (mode) {
+    case ADMISSION_OFF:
+        return "off";
+    case ADMISSION_FLAG:
+        return "flag";
+    case ADMISSION_REJECT:
+        return "reject";
+    }
+    return "unknown";
+}
+
+typedef struct DemandEntry {
+    int deadline;
+    int remaining;
+} DemandEntry;
+
+static int compare_demand(const void* a, const void* b) {
+    const DemandEntry* x = a;
+    const DemandEntry* y = b;
+    return (x->deadline > y->deadline) - (x->deadline < y->deadline);
+}
+
+/**
+ * @brief EDF admission test: can `candidate` meet its deadline without making an active job miss?
+ * @details Processor demand test on one preemptive CPU. With the active deadline jobs in
+ *          deadline order, a job finishes by now + (remaining work up to and including it).
+ *          The candidate must fit before its own deadline, and every later-deadline job that is
+ *          currently on time must stay on time once the candidate's runtime is added to it.
+ *          O(n log n) in the number of active jobs.
+ *
+ * @param[in] now current time
+ * @param[in] candidate process asking to be admitted
+ * @param[in] active running and ready processes (may include jobs without a deadline)
+ * @param[in] count number of active processes
+ *
+ * @return int 1 if the deadline can be guaranteed (or there is none), 0 otherwise
+ */
+int policy_deadline_feasible(int now, PCB* candidate, PCB** active, int count) {
+    int deadline = candidate->PDATA.deadline;
+    if (deadline <= 0) {
+        return 1;
+    }
+
+    DemandEntry* entries = malloc((count > 0 ? count : 1) * sizeof(DemandEntry));
+    if (entries == NULL) {
+        return 1; // cannot judge, do not refuse work
+    }
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (active[i] != candidate && active[i]->PDATA.deadline > 0) {
+            entries[n].deadline = active[i]->PDATA.deadline;
+            entries[n].remaining = active[i]->remaining_time;
+            n++;
+        }
+    }
+    qsort(entries, n, sizeof(DemandEntry), compare_demand);
+
+    long long finish = now;
+    long long candidate_finish = -1;
+    int feasible = 1;
+    for (int i = 0; i < n && feasible; i++) {
+        if (candidate_finish < 0 && entries[i].deadline > deadline) {
+            candidate_finish = finish + candidate->remaining_time;
+        }
+        finish += entries[i].remaining;
+        // Jobs ordered after the candidate are delayed by its runtime
+        if (candidate_finish >= 0 && finish <= entries[i].deadline && finish + candidate->remaining_time > entries[i].deadline) {
+            feasible = 0;
+        }
+    }
+    if (candidate_finish < 0) {
+        candidate_finish = finish + candidate->remaining_time;
+    }
+
+    free(entries);
+    return feasible && candidate_finish <= deadline;
+}
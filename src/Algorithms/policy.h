@@ -0,0 +1,51 @@
+#ifndef ALG_POLICY_H
+#define ALG_POLICY_H
+
+#include "utils.h"
+#include "../PCB.h"
+
+/**
+ * Scheduling policy decisions shared by the IPC scheduler (scheduler.c)
+ * and the library-mode simulation engine (sim_engine.c).
+ */
+
+int parse_algorithm(const char* name, SchedulingAlgorithm* algorithm);
+const char* algorithm_name(SchedulingAlgorithm algorithm);
+long long policy_priority(SchedulingAlgorithm algorithm, PCB* pcb);
+long long policy_queue_key(SchedulingAlgorithm algorithm, int aging_interval, PCB* pcb);
+int policy_is_preemptive(SchedulingAlgorithm algorithm);
+int policy_runs_to_completion(SchedulingAlgorithm algorithm);
+int policy_uses_burst(SchedulingAlgorithm algorithm);
+int policy_uses_quantum(SchedulingAlgorithm algorithm);
+int policy_should_preempt(SchedulingAlgorithm algorithm, PCB* running, PCB* next);
+
+// Proportional share: priority 0 holds SHARE_TICKET_LEVELS tickets, priority 10 and above one
+#define SHARE_TICKET_LEVELS 11
+#define STRIDE_UNIT 27720 // divisible by every ticket count 1..12, so strides are exact
+
+/**
+ * Fair share clock of the lottery and stride schedulers. virtual_time is the CPU time one
+ * ticket was entitled to so far under ideal proportional sharing among the ready and running
+ * processes, so a process holding t tickets is entitled to t * (virtual_time - share_start).
+ * pass is the stride scheduler's global pass: newly ready processes start from it.
+ */
+typedef struct ShareClock {
+    double virtual_time;
+    long long tickets; // tickets of the ready and running processes
+    int updated_at;
+    long long pass;
+} ShareClock;
+
+int policy_is_proportional_share(SchedulingAlgorithm algorithm);
+int policy_tickets(PCB* pcb);
+void policy_charge(SchedulingAlgorithm algorithm, PCB* pcb, int ran);
+void share_clock_init(ShareClock* clock, int now);
+void share_clock_join(ShareClock* clock, PCB* pcb, int now);
+void share_clock_dispatch(ShareClock* clock, PCB* pcb);
+void share_clock_leave(ShareClock* clock, PCB* pcb, int now);
+
+int parse_admission(const char* name, AdmissionMode* mode);
+const char* admission_name(AdmissionMode mode);
+int policy_deadline_feasible(int now, PCB* candidate, PCB** active, int count);
+
+#endif /* ALG_POLICY_H */
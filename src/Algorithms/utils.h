@@ -1,7 +1,10 @@
 #ifndef ALG_UTILS_H
 #define ALG_UTILS_H
 
-typedef enum SchedulingAlgorithm { RR, HPF, SRTN } SchedulingAlgorithm;
+typedef enum SchedulingAlgorithm { RR, HPF, SRTN, EDF, RM, LOTTERY, STRIDE, SJF, HRRN } SchedulingAlgorithm;
+
+// What admission control does with a deadline it cannot guarantee (EDF only)
+typedef enum AdmissionMode { ADMISSION_OFF, ADMISSION_FLAG, ADMISSION_REJECT } AdmissionMode;
 
 
 
@@ -8,8 +8,18 @@ void init_queue(IQueue* queue, SchedulingAlgorithm algType) {
             break;
         case HPF:
         case SRTN:
+        case EDF:
+        case RM:
+        case STRIDE:
+        case SJF:
             type = PRIORITY_QUEUE;
             break;
+        case LOTTERY:
+            type = LOTTERY_QUEUE;
+            break;
+        case HRRN:
+            type = KINETIC_QUEUE;
+            break;
         default:
             type = CIRCULAR_QUEUE; // Default to circular queue
             break;
@@ -22,10 +32,16 @@ void init_queue(IQueue* queue, SchedulingAlgorithm algType) {
         case PRIORITY_QUEUE:
             queue->q = priority_queue();
             break;
+        case LOTTERY_QUEUE:
+            queue->q = lottery_queue();
+            break;
+        case KINETIC_QUEUE:
+            queue->q = kinetic_queue();
+            break;
     }
 }
 
-void enqueue(IQueue* queue, void* obj, int priority) {
+void enqueue(IQueue* queue, void* obj, long long priority) {
     switch (queue->type) {
         case CIRCULAR_QUEUE:
             cq_enqueue((CircularQueue*)queue->q, obj);
@@ -33,6 +49,12 @@ void enqueue(IQueue* queue, void* obj, int priority) {
         case PRIORITY_QUEUE:
             pq_enqueue((PriorityQueue*)queue->q, obj, priority);
             break;
+        case LOTTERY_QUEUE: // the priority is the ticket count
+            lq_enqueue((LotteryQueue*)queue->q, obj, (int)priority);
+            break;
+        case KINETIC_QUEUE: // the priority packs the arrival (high 32 bits) and the service time (low 32 bits)
+            kq_enqueue((KineticQueue*)queue->q, obj, priority >> 32, priority & 0xFFFFFFFFLL);
+            break;
         default:
             break;
     }
@@ -49,6 +71,17 @@ void* dequeue(IQueue* queue, int remove) {
             }
         case PRIORITY_QUEUE:
             return pq_dequeue((PriorityQueue*)queue->q);
+        case LOTTERY_QUEUE:
+            if (remove) {
+                return lq_dequeue((LotteryQueue*)queue->q);
+            }
+            else { // the winner used its turn: keep it and hold a new lottery
+                void* obj = lq_front((LotteryQueue*)queue->q);
+                lq_redraw((LotteryQueue*)queue->q);
+                return obj;
+            }
+        case KINETIC_QUEUE:
+            return kq_dequeue((KineticQueue*)queue->q);
         default:
             return NULL;
     }
@@ -60,6 +93,10 @@ void* front(IQueue* queue) {
             return cq_front((CircularQueue*)queue->q);
         case PRIORITY_QUEUE:
             return pq_front((PriorityQueue*)queue->q);
+        case LOTTERY_QUEUE:
+            return lq_front((LotteryQueue*)queue->q);
+        case KINETIC_QUEUE:
+            return kq_front((KineticQueue*)queue->q);
         default:
             return NULL;
     }
@@ -71,6 +108,10 @@ int is_empty(IQueue* queue) {
             return cq_is_empty((CircularQueue*)queue->q);
         case PRIORITY_QUEUE:
             return pq_is_empty((PriorityQueue*)queue->q);
+        case LOTTERY_QUEUE:
+            return lq_is_empty((LotteryQueue*)queue->q);
+        case KINETIC_QUEUE:
+            return kq_is_empty((KineticQueue*)queue->q);
         default:
             return 1;
     }
@@ -84,6 +125,12 @@ void free_queue(IQueue* queue) {
         case PRIORITY_QUEUE:
             pq_free((PriorityQueue*)queue->q);
             break;
+        case LOTTERY_QUEUE:
+            lq_free((LotteryQueue*)queue->q);
+            break;
+        case KINETIC_QUEUE:
+            kq_free((KineticQueue*)queue->q);
+            break;
     }
 }
 
@@ -93,14 +140,50 @@ int size(IQueue* queue) {
             return cq_size((CircularQueue*)queue->q);
         case PRIORITY_QUEUE:
             return pq_size((PriorityQueue*)queue->q);
+        case LOTTERY_QUEUE:
+            return lq_size((LotteryQueue*)queue->q);
+        case KINETIC_QUEUE:
+            return kq_size((KineticQueue*)queue->q);
         default:
             return 0;
     }
 }
 
 
-void change_priority(IQueue* queue, int index, int new_priority) {
+void change_priority(IQueue* queue, int index, long long new_priority) {
     if (queue->type == PRIORITY_QUEUE) {
         pq_change_priority((PriorityQueue*)queue->q, index, new_priority);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Item at position `index` (0 .. size - 1) in storage order, not in dequeue order
+ */
+void* queue_at(IQueue* queue, int index) {
+    switch (queue->type) {
+        case CIRCULAR_QUEUE: {
+            QueueNode* node = ((CircularQueue*)queue->q)->head;
+            for (int i = 0; i < index && node != NULL; i++) {
+                node = node->next;
+            }
+            return node != NULL ? node->obj : NULL;
+        }
+        case PRIORITY_QUEUE:
+            return ((PriorityQueue*)queue->q)->nodes[index]->item;
+        case LOTTERY_QUEUE:
+            return lq_at((LotteryQueue*)queue->q, index);
+        case KINETIC_QUEUE:
+            return kq_at((KineticQueue*)queue->q, index);
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * @brief Tell a time-dependent queue the current time before front() / dequeue()
+ */
+void queue_advance(IQueue* queue, int now) {
+    if (queue->type == KINETIC_QUEUE) {
+        kq_advance((KineticQueue*)queue->q, now);
+    }
+}
@@ -2,9 +2,11 @@
 #define QUEUE_INTERFACE_H
 #include "circular_queue.h"
 #include "priority_queue.h"
+#include "lottery_queue.h"
+#include "kinetic_queue.h"
 #include "../Algorithms/utils.h"
 
-typedef enum QueueType { CIRCULAR_QUEUE, PRIORITY_QUEUE } QueueType;
+typedef enum QueueType { CIRCULAR_QUEUE, PRIORITY_QUEUE, LOTTERY_QUEUE, KINETIC_QUEUE } QueueType;
 
 typedef struct IQueue
 {
@@ -13,13 +15,15 @@ typedef struct IQueue
 } IQueue;
 
 void init_queue(IQueue* queue, SchedulingAlgorithm algType);
-void enqueue(IQueue* queue, void* obj, int priority);
+void enqueue(IQueue* queue, void* obj, long long priority);
 void* dequeue(IQueue* queue, int remove);
 void* front(IQueue* queue);
 int is_empty(IQueue* queue);
 void free_queue(IQueue* queue);
 int size(IQueue* queue);
-void change_priority(IQueue* queue, int index, int new_priority);
+void change_priority(IQueue* queue, int index, long long new_priority);
+void* queue_at(IQueue* queue, int index);
+void queue_advance(IQueue* queue, int now);
 
 
 #endif /* QUEUE_INTERFACE_H */
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "disk_queue.h"
+#include "../logger.h"
+
+static void dq_tree_add(DiskQueue* dq, int cylinder, int delta) {
+    for (int i = cylinder + 1; i <= dq->cylinders; i += i & -i) {
+        dq->tree[i] += delta;
+    }
+}
+
+/**
+ * @brief Number of requests at cylinders 0 .. cylinder
+ */
+static int dq_prefix(DiskQueue* dq, int cylinder) {
+    int count = 0;
+    for (int i = cylinder + 1; i > 0; i -= i & -i) {
+        count += dq->tree[i];
+    }
+    return count;
+}
+
+/**
+ * @brief Lowest cylinder holding the rank-th request (1-based) in cylinder order
+ */
+static int dq_find(DiskQueue* dq, int rank) {
+    int step = 1;
+    while (step * 2 <= dq->cylinders) {
+        step *= 2;
+    }
+
+    int position = 0;
+    for (; step > 0; step >>= 1) {
+        if (position + step <= dq->cylinders && dq->tree[position + step] < rank) {
+            position += step;
+            rank -= dq->tree[position];
+        }
+    }
+    return position; // 0-based cylinder
+}
+
+/**
+ * @brief Create an empty disk queue for cylinders 0 .. cylinders - 1
+ * @return DiskQueue* Pointer to the newly created DiskQueue
+ */
+DiskQueue* disk_queue(int cylinders) {
+    DiskQueue* dq = (DiskQueue*)malloc(sizeof(DiskQueue));
+    dq->cylinders = cylinders;
+    dq->size = 0;
+    dq->first = (DiskRequest**)calloc(cylinders, sizeof(DiskRequest*));
+    dq->last = (DiskRequest**)calloc(cylinders, sizeof(DiskRequest*));
+    dq->tree = (int*)calloc(cylinders + 1, sizeof(int));
+    if (dq->first == NULL || dq->last == NULL || dq->tree == NULL) {
+        LOG_ERROR("Error: Failed to allocate memory for disk queue.\n");
+    }
+    return dq;
+}
+
+/**
+ * @brief Queue a request for `cylinder` behind the other requests for it
+ */
+void dq_push(DiskQueue* dq, void* item, int cylinder) {
+    DiskRequest* request = (DiskRequest*)malloc(sizeof(DiskRequest));
+    request->item = item;
+    request->next = NULL;
+    if (dq->last[cylinder] != NULL) {
+        dq->last[cylinder]->next = request;
+    }
+    else {
+        dq->first[cylinder] = request;
+    }
+    dq->last[cylinder] = request;
+    dq_tree_add(dq, cylinder, 1);
+    dq->size++;
+}
+
+/**
+ * @brief Remove and return the oldest request for `cylinder`
+ * @return void* Pointer to the item, or NULL if there is no request for the cylinder
+ */
+void* dq_pop(DiskQueue* dq, int cylinder) {
+    DiskRequest* request = dq->first[cylinder];
+    if (request == NULL) return NULL;
+
+    dq->first[cylinder] = request->next;
+    if (request->next == NULL) {
+        dq->last[cylinder] = NULL;
+    }
+    void* item = request->item;
+    free(request);
+    dq_tree_add(dq, cylinder, -1);
+    dq->size--;
+    return item;
+}
+
+/**
+ * @brief Lowest cylinder >= `cylinder` with a pending request, -1 if there is none
+ */
+int dq_ceiling(DiskQueue* dq, int cylinder) {
+    int below = cylinder > 0 ? dq_prefix(dq, cylinder - 1) : 0;
+    return below < dq->size ? dq_find(dq, below + 1) : -1;
+}
+
+/**
+ * @brief Highest cylinder <= `cylinder` with a pending request, -1 if there is none
+ */
+int dq_floor(DiskQueue* dq, int cylinder) {
+    int upto = dq_prefix(dq, cylinder);
+    return upto > 0 ? dq_find(dq, upto) : -1;
+}
+
+int dq_size(DiskQueue* dq) {
+    return dq->size;
+}
+
+/**
+ * @brief Free the disk queue (the items themselves are not freed)
+ */
+void dq_free(DiskQueue* dq) {
+    for (int cylinder = 0; cylinder < dq->cylinders; cylinder++) {
+        while (dq->first[cylinder] != NULL) {
+            dq_pop(dq, cylinder);
+        }
+    }
+    free(dq->first);
+    free(dq->last);
+    free(dq->tree);
+    free(dq);
+}
@@ -0,0 +1,32 @@
+#ifndef DISK_QUEUE_H
+#define DISK_QUEUE_H
+
+#include <stdlib.h>
+
+/**
+ * Disk request queue: pending requests bucketed by cylinder, FIFO within a cylinder.
+ * A Fenwick tree counts the requests per cylinder so the nearest pending cylinder at
+ * or above / at or below any position is found in O(log cylinders).
+ */
+typedef struct DiskRequest {
+    void* item;
+    struct DiskRequest* next;
+} DiskRequest;
+
+typedef struct {
+    DiskRequest** first; // per cylinder, oldest request
+    DiskRequest** last;  // per cylinder, newest request
+    int* tree;           // Fenwick tree over the request count per cylinder (1-based)
+    int cylinders;
+    int size;
+} DiskQueue;
+
+DiskQueue* disk_queue(int cylinders);
+void dq_push(DiskQueue* dq, void* item, int cylinder);
+void* dq_pop(DiskQueue* dq, int cylinder);
+int dq_ceiling(DiskQueue* dq, int cylinder);
+int dq_floor(DiskQueue* dq, int cylinder);
+int dq_size(DiskQueue* dq);
+void dq_free(DiskQueue* dq);
+
+#endif /* DISK_QUEUE_H */
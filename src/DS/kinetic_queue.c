@@ -0,0 +1,235 @@
+#include <limits.h>
+#include "kinetic_queue.h"
+#include "../logger.h"
+
+#define KQ_NEVER LLONG_MAX
+
+/**
+ * @brief Whether slot `i` ranks before slot `j` at `now`: the higher (now - arrival) / service,
+ *        then the shorter service, then the earlier arrival
+ */
+static int kq_before(const KineticQueue* kq, int i, int j) {
+    long long lhs = (kq->now - kq->arrival[i]) * kq->service[j];
+    long long rhs = (kq->now - kq->arrival[j]) * kq->service[i];
+    if (lhs != rhs) {
+        return lhs > rhs;
+    }
+    if (kq->service[i] != kq->service[j]) {
+        return kq->service[i] < kq->service[j];
+    }
+    if (kq->arrival[i] != kq->arrival[j]) {
+        return kq->arrival[i] < kq->arrival[j];
+    }
+    return i < j;
+}
+
+static long long floor_div(long long a, long long b) {
+    long long q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+/**
+ * @brief Earliest time the loser can overtake the winner
+ * @details The key difference winner - loser is linear in time; it only shrinks when the loser
+ *          has the shorter service. The result may be early (never late): an early melt only
+ *          re-runs a comparison.
+ */
+static long long kq_certificate(const KineticQueue* kq, int winner, int loser) {
+    long long slope = kq->service[winner] - kq->service[loser];
+    if (slope <= 0) {
+        return KQ_NEVER;
+    }
+    long long crossing = floor_div(kq->arrival[loser] * kq->service[winner] - kq->arrival[winner] * kq->service[loser], slope);
+    return crossing > kq->now ? crossing : kq->now + 1;
+}
+
+/**
+ * @brief Recompute an internal node from its (valid) children
+ */
+static void kq_pull(KineticQueue* kq, int node) {
+    int left = kq->winner[2 * node];
+    int right = kq->winner[2 * node + 1];
+    long long melt = kq->melt[2 * node] < kq->melt[2 * node + 1] ? kq->melt[2 * node] : kq->melt[2 * node + 1];
+
+    if (left < 0 || right < 0) {
+        kq->winner[node] = left < 0 ? right : left;
+    }
+    else {
+        int winner = kq_before(kq, left, right) ? left : right;
+        int loser = winner == left ? right : left;
+        long long certificate = kq_certificate(kq, winner, loser);
+        kq->winner[node] = winner;
+        if (certificate < melt) {
+            melt = certificate;
+        }
+    }
+    kq->melt[node] = melt;
+}
+
+/**
+ * @brief Set a leaf and recompute its path to the root
+ */
+static void kq_update(KineticQueue* kq, int slot) {
+    int node = kq->capacity + slot;
+    kq->winner[node] = kq->items[slot] != NULL ? slot : -1;
+    kq->melt[node] = KQ_NEVER;
+    for (node /= 2; node >= 1; node /= 2) {
+        kq_pull(kq, node);
+    }
+}
+
+/**
+ * @brief Recompute every melted node of a subtree at kq->now
+ */
+static void kq_refresh(KineticQueue* kq, int node) {
+    if (node >= kq->capacity || kq->melt[node] > kq->now) {
+        return;
+    }
+    kq_refresh(kq, 2 * node);
+    kq_refresh(kq, 2 * node + 1);
+    kq_pull(kq, node);
+}
+
+/**
+ * @brief Allocate the slot and tree arrays for `capacity` slots and rebuild the tree
+ */
+static int kq_resize(KineticQueue* kq, int capacity) {
+    int old_capacity = kq->capacity;
+    void** items = realloc(kq->items, capacity * sizeof(void*));
+    long long* arrival = realloc(kq->arrival, capacity * sizeof(long long));
+    long long* service = realloc(kq->service, capacity * sizeof(long long));
+    int* free_slots = realloc(kq->free_slots, capacity * sizeof(int));
+    int* winner = realloc(kq->winner, 2 * capacity * sizeof(int));
+    long long* melt = realloc(kq->melt, 2 * capacity * sizeof(long long));
+    if (items != NULL) kq->items = items;
+    if (arrival != NULL) kq->arrival = arrival;
+    if (service != NULL) kq->service = service;
+    if (free_slots != NULL) kq->free_slots = free_slots;
+    if (winner != NULL) kq->winner = winner;
+    if (melt != NULL) kq->melt = melt;
+    if (items == NULL || arrival == NULL || service == NULL || free_slots == NULL || winner == NULL || melt == NULL) {
+        LOG_ERROR("Error: Failed to realloc memory for kinetic queue.\n");
+        return 1;
+    }
+
+    for (int slot = old_capacity; slot < capacity; slot++) {
+        kq->items[slot] = NULL;
+    }
+    // new slots are handed out lowest first
+    for (int slot = capacity - 1; slot >= old_capacity; slot--) {
+        kq->free_slots[kq->free_count++] = slot;
+    }
+
+    kq->capacity = capacity;
+    for (int slot = 0; slot < capacity; slot++) {
+        kq->winner[capacity + slot] = kq->items[slot] != NULL ? slot : -1;
+        kq->melt[capacity + slot] = KQ_NEVER;
+    }
+    for (int node = capacity - 1; node >= 1; node--) {
+        kq_pull(kq, node);
+    }
+    return 0;
+}
+
+/**
+ * @brief Create a new kinetic queue
+ * @return KineticQueue* Pointer to the newly created KineticQueue, or NULL if allocation fails
+ */
+KineticQueue* kinetic_queue() {
+    KineticQueue* kq = (KineticQueue*)calloc(1, sizeof(KineticQueue));
+    if (kq == NULL) {
+        LOG_ERROR("Error: Failed to allocate memory for kinetic queue.\n");
+        return NULL;
+    }
+    if (kq_resize(kq, 64) != 0) {
+        kq_free(kq);
+        return NULL;
+    }
+    return kq;
+}
+
+/**
+ * @brief Add an item with its arrival time and service time (at least one tick)
+ * @param[in] kq Pointer to the KineticQueue structure
+ * @param[in] item Pointer to the item itself to enqueue
+ * @return void
+ */
+void kq_enqueue(KineticQueue* kq, void* item, long long arrival, long long service) {
+    if (kq->free_count == 0 && kq_resize(kq, 2 * kq->capacity) != 0) {
+        return;
+    }
+    int slot = kq->free_slots[--kq->free_count];
+    kq->items[slot] = item;
+    kq->arrival[slot] = arrival;
+    kq->service[slot] = service > 0 ? service : 1;
+    kq->size++;
+    kq_update(kq, slot);
+}
+
+/**
+ * @brief Move the tournament forward to `now` (time never goes back)
+ */
+void kq_advance(KineticQueue* kq, long long now) {
+    if (now <= kq->now) {
+        return;
+    }
+    kq->now = now;
+    kq_refresh(kq, 1);
+}
+
+/**
+ * @brief Item with the highest response ratio at the last advanced time
+ * @return void* Pointer to the item, or NULL if the queue is empty
+ */
+void* kq_front(KineticQueue* kq) {
+    if (kq->size == 0) return NULL;
+    return kq->items[kq->winner[1]];
+}
+
+/**
+ * @brief Remove and return the item with the highest response ratio
+ * @return void* Pointer to the dequeued item, or NULL if the queue is empty
+ */
+void* kq_dequeue(KineticQueue* kq) {
+    if (kq->size == 0) return NULL;
+    int slot = kq->winner[1];
+    void* item = kq->items[slot];
+    kq->items[slot] = NULL;
+    kq->free_slots[kq->free_count++] = slot;
+    kq->size--;
+    kq_update(kq, slot);
+    return item;
+}
+
+/**
+ * @brief Item at position `index` (0 .. size - 1) in slot order
+ */
+void* kq_at(KineticQueue* kq, int index) {
+    for (int slot = 0; slot < kq->capacity; slot++) {
+        if (kq->items[slot] != NULL && index-- == 0) {
+            return kq->items[slot];
+        }
+    }
+    return NULL;
+}
+
+int kq_size(KineticQueue* kq) {
+    return kq->size;
+}
+
+int kq_is_empty(KineticQueue* kq) {
+    return kq->size == 0;
+}
+
+/**
+ * @brief Free the kinetic queue (the items themselves are not freed)
+ */
+void kq_free(KineticQueue* kq) {
+    free(kq->items);
+    free(kq->arrival);
+    free(kq->service);
+    free(kq->free_slots);
+    free(kq->winner);
+    free(kq->melt);
+    free(kq);
+}
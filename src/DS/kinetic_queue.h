@@ -0,0 +1,36 @@
+#ifndef KINETIC_QUEUE_H
+#define KINETIC_QUEUE_H
+
+#include <stdlib.h>
+
+/**
+ * Kinetic tournament over items whose key grows linearly with time:
+ * (now - arrival) / service, the waiting part of HRRN's response ratio.
+ * Every tree node keeps the winner of its subtree at `now` and the earliest time one
+ * of the comparisons below it can change (its melt time). Advancing the clock only
+ * revisits melted nodes, so the max is found without rescanning the queue.
+ */
+typedef struct {
+    void** items;      // item per slot, NULL when the slot is free
+    long long* arrival;
+    long long* service;
+    int* winner;       // per tree node (1 .. 2 * capacity - 1), winning slot or -1
+    long long* melt;   // per tree node, time the winner has to be recomputed
+    int* free_slots;   // stack of free slots
+    int free_count;
+    int capacity;      // number of slots (leaves), always a power of two
+    int size;          // number of items
+    long long now;     // time the tournament is valid at
+} KineticQueue;
+
+KineticQueue* kinetic_queue();
+void kq_enqueue(KineticQueue* kq, void* item, long long arrival, long long service);
+void kq_advance(KineticQueue* kq, long long now);
+void* kq_front(KineticQueue* kq);
+void* kq_dequeue(KineticQueue* kq);
+void* kq_at(KineticQueue* kq, int index);
+int kq_size(KineticQueue* kq);
+int kq_is_empty(KineticQueue* kq);
+void kq_free(KineticQueue* kq);
+
+#endif /* KINETIC_QUEUE_H */
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include "linked_list.h"
 #include "../PCB.h"
+#include "../logger.h"
 
 Node *create_node(void *obj)
 {
@@ -15,7 +16,7 @@ Node *create_node(void *obj)
 void add_node_to_back(LinkedList *listPtr, Node *nodePtr)
 {
     PCB * PPP = (PCB* ) nodePtr->data;
-    printf("LL : Process (PID: %d) IAM HERE" "\n" , PPP->pid);
+    LOG_TRACE("LL : Process (PID: %d) IAM HERE" "\n" , PPP->pid);
 
     listPtr->size++;
     if (listPtr->head == NULL)
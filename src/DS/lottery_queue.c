@@ -0,0 +1,189 @@
+#include "lottery_queue.h"
+#include "../logger.h"
+
+/**
+ * @brief Add `delta` tickets to a slot in the Fenwick tree
+ */
+static void lq_tree_add(LotteryQueue* lq, int slot, long long delta) {
+    for (int i = slot + 1; i <= lq->capacity; i += i & -i) {
+        lq->tree[i] += delta;
+    }
+}
+
+/**
+ * @brief Double the number of slots and rebuild the Fenwick tree in O(n)
+ */
+static int lq_grow(LotteryQueue* lq) {
+    int old_capacity = lq->capacity;
+    int capacity = old_capacity * 2;
+    void** items = realloc(lq->items, capacity * sizeof(void*));
+    int* tickets = realloc(lq->tickets, capacity * sizeof(int));
+    int* free_slots = realloc(lq->free_slots, capacity * sizeof(int));
+    long long* tree = realloc(lq->tree, (capacity + 1) * sizeof(long long));
+    if (items != NULL) lq->items = items;
+    if (tickets != NULL) lq->tickets = tickets;
+    if (free_slots != NULL) lq->free_slots = free_slots;
+    if (tree != NULL) lq->tree = tree;
+    if (items == NULL || tickets == NULL || free_slots == NULL || tree == NULL) {
+        LOG_ERROR("Error: Failed to realloc memory for lottery queue.\n");
+        return 1;
+    }
+
+    for (int slot = old_capacity; slot < capacity; slot++) {
+        lq->items[slot] = NULL;
+        lq->tickets[slot] = 0;
+    }
+    // new slots are handed out lowest first
+    for (int slot = capacity - 1; slot >= old_capacity; slot--) {
+        lq->free_slots[lq->free_count++] = slot;
+    }
+
+    lq->capacity = capacity;
+    for (int i = 1; i <= capacity; i++) {
+        lq->tree[i] = lq->tickets[i - 1];
+    }
+    for (int i = 1; i <= capacity; i++) {
+        int parent = i + (i & -i);
+        if (parent <= capacity) {
+            lq->tree[parent] += lq->tree[i];
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Draw the winning slot: the first slot whose ticket prefix sum exceeds a
+ *        uniform number in [0, total)
+ */
+static int lq_draw(LotteryQueue* lq) {
+    // xorshift64*
+    lq->rng ^= lq->rng >> 12;
+    lq->rng ^= lq->rng << 25;
+    lq->rng ^= lq->rng >> 27;
+    long long target = (long long)((lq->rng * 2685821657736338717ULL) % (uint64_t)lq->total);
+
+    int position = 0;
+    for (int step = lq->capacity; step > 0; step >>= 1) {
+        if (position + step <= lq->capacity && lq->tree[position + step] <= target) {
+            position += step;
+            target -= lq->tree[position];
+        }
+    }
+    return position; // 0-based slot of the winner
+}
+
+/**
+ * @brief Create a new lottery queue
+ * @return LotteryQueue* Pointer to the newly created LotteryQueue
+ */
+LotteryQueue* lottery_queue() {
+    LotteryQueue* lq = (LotteryQueue*)malloc(sizeof(LotteryQueue));
+    lq->capacity = 64;
+    lq->items = (void**)calloc(lq->capacity, sizeof(void*));
+    lq->tickets = (int*)calloc(lq->capacity, sizeof(int));
+    lq->tree = (long long*)calloc(lq->capacity + 1, sizeof(long long));
+    lq->free_slots = (int*)malloc(lq->capacity * sizeof(int));
+    lq->free_count = 0;
+    for (int slot = lq->capacity - 1; slot >= 0; slot--) {
+        lq->free_slots[lq->free_count++] = slot;
+    }
+    lq->size = 0;
+    lq->total = 0;
+    lq->drawn = -1;
+    lq->rng = 0x9E3779B97F4A7C15ULL;
+    return lq;
+}
+
+/**
+ * @brief Add an item holding `tickets` tickets (at least one)
+ * @param[in] lq Pointer to the LotteryQueue structure
+ * @param[in] item Pointer to the item itself to enqueue
+ * @param[in] tickets Number of tickets the item holds
+ * @return void
+ */
+void lq_enqueue(LotteryQueue* lq, void* item, int tickets) {
+    if (lq->free_count == 0 && lq_grow(lq) != 0) {
+        return;
+    }
+    if (tickets < 1) {
+        tickets = 1;
+    }
+    int slot = lq->free_slots[--lq->free_count];
+    lq->items[slot] = item;
+    lq->tickets[slot] = tickets;
+    lq_tree_add(lq, slot, tickets);
+    lq->total += tickets;
+    lq->size++;
+}
+
+/**
+ * @brief Winner of the current draw. The draw is held until the winner is
+ *        dequeued or lq_redraw() is called, so repeated calls agree.
+ * @param[in] lq Pointer to the LotteryQueue structure
+ * @return void* Pointer to the winning item, or NULL if the queue is empty
+ */
+void* lq_front(LotteryQueue* lq) {
+    if (lq->size == 0) return NULL;
+    if (lq->drawn < 0) {
+        lq->drawn = lq_draw(lq);
+    }
+    return lq->items[lq->drawn];
+}
+
+/**
+ * @brief Remove and return the winner of the current draw
+ * @param[in] lq Pointer to the LotteryQueue structure
+ * @return void* Pointer to the dequeued item, or NULL if the queue is empty
+ */
+void* lq_dequeue(LotteryQueue* lq) {
+    void* item = lq_front(lq);
+    if (item == NULL) return NULL;
+
+    int slot = lq->drawn;
+    lq_tree_add(lq, slot, -lq->tickets[slot]);
+    lq->total -= lq->tickets[slot];
+    lq->items[slot] = NULL;
+    lq->tickets[slot] = 0;
+    lq->free_slots[lq->free_count++] = slot;
+    lq->size--;
+    lq->drawn = -1;
+    return item;
+}
+
+/**
+ * @brief Forget the current draw so the next front() holds a new lottery
+ */
+void lq_redraw(LotteryQueue* lq) {
+    lq->drawn = -1;
+}
+
+/**
+ * @brief Item at position `index` (0 .. size - 1) in slot order
+ */
+void* lq_at(LotteryQueue* lq, int index) {
+    for (int slot = 0; slot < lq->capacity; slot++) {
+        if (lq->items[slot] != NULL && index-- == 0) {
+            return lq->items[slot];
+        }
+    }
+    return NULL;
+}
+
+int lq_size(LotteryQueue* lq) {
+    return lq->size;
+}
+
+int lq_is_empty(LotteryQueue* lq) {
+    return lq->size == 0;
+}
+
+/**
+ * @brief Free the lottery queue (the items themselves are not freed)
+ */
+void lq_free(LotteryQueue* lq) {
+    free(lq->items);
+    free(lq->tickets);
+    free(lq->tree);
+    free(lq->free_slots);
+    free(lq);
+}
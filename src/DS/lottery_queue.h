@@ -0,0 +1,35 @@
+#ifndef LOTTERY_QUEUE_H
+#define LOTTERY_QUEUE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+/**
+ * Lottery queue: every item holds a number of tickets and front() draws a winner
+ * with probability tickets / total. Tickets live in a Fenwick tree indexed by slot
+ * so both the draw and the ticket updates are O(log n).
+ */
+typedef struct {
+    void** items;       // item per slot, NULL when the slot is free
+    int* tickets;       // tickets per slot
+    long long* tree;    // Fenwick tree over tickets (1-based)
+    int* free_slots;    // stack of free slots
+    int free_count;
+    int capacity;       // number of slots, always a power of two
+    int size;           // number of items
+    long long total;    // sum of all tickets
+    int drawn;          // slot of the current winner, -1 when no draw is pending
+    uint64_t rng;       // xorshift state, fixed seed so runs are reproducible
+} LotteryQueue;
+
+LotteryQueue* lottery_queue();
+void lq_enqueue(LotteryQueue* lq, void* item, int tickets);
+void* lq_front(LotteryQueue* lq);
+void* lq_dequeue(LotteryQueue* lq);
+void lq_redraw(LotteryQueue* lq);
+void* lq_at(LotteryQueue* lq, int index);
+int lq_size(LotteryQueue* lq);
+int lq_is_empty(LotteryQueue* lq);
+void lq_free(LotteryQueue* lq);
+
+#endif /* LOTTERY_QUEUE_H */
@@ -0,0 +1,90 @@
+#include "order_queue.h"
+#include "../logger.h"
+
+/**
+ * @brief Create an empty order queue
+ * @return OrderQueue* Pointer to the newly created OrderQueue
+ */
+OrderQueue* order_queue(void) {
+    OrderQueue* oq = (OrderQueue*)calloc(1, sizeof(OrderQueue));
+    if (oq == NULL) {
+        LOG_ERROR("Error: Failed to allocate memory for order queue.\n");
+    }
+    return oq;
+}
+
+/**
+ * @brief Queue an item needing a block of `order` behind the others of that order
+ */
+void oq_push(OrderQueue* oq, void* item, int order, int since) {
+    OrderEntry* entry = (OrderEntry*)malloc(sizeof(OrderEntry));
+    entry->item = item;
+    entry->seq = oq->next_seq++;
+    entry->since = since;
+    entry->next = NULL;
+    if (oq->last[order] != NULL) {
+        oq->last[order]->next = entry;
+    }
+    else {
+        oq->first[order] = entry;
+    }
+    oq->last[order] = entry;
+    oq->orders |= 1u << order;
+    oq->size++;
+}
+
+/**
+ * @brief Oldest entry of `order`, NULL if there is none; follow `next` for the younger ones
+ */
+OrderEntry* oq_front(const OrderQueue* oq, int order) {
+    return oq->first[order];
+}
+
+/**
+ * @brief Remove the entry of `order` that follows `prev` (the oldest one when `prev` is NULL)
+ * @return void* Pointer to the item, or NULL if there is no such entry
+ */
+void* oq_remove(OrderQueue* oq, int order, OrderEntry* prev) {
+    OrderEntry* entry = prev != NULL ? prev->next : oq->first[order];
+    if (entry == NULL) return NULL;
+
+    if (prev != NULL) {
+        prev->next = entry->next;
+    }
+    else {
+        oq->first[order] = entry->next;
+    }
+    if (oq->last[order] == entry) {
+        oq->last[order] = prev;
+    }
+    if (oq->first[order] == NULL) {
+        oq->orders &= ~(1u << order);
+    }
+    void* item = entry->item;
+    free(entry);
+    oq->size--;
+    return item;
+}
+
+/**
+ * @brief Remove and return the oldest item of `order`
+ */
+void* oq_pop(OrderQueue* oq, int order) {
+    return oq_remove(oq, order, NULL);
+}
+
+int oq_size(const OrderQueue* oq) {
+    return oq->size;
+}
+
+/**
+ * @brief Free the order queue (the items themselves are not freed)
+ */
+void oq_free(OrderQueue* oq) {
+    for (int order = 0; order < ORDER_QUEUE_ORDERS; order++) {
+        while (oq->first[order] != NULL) {
+            oq_pop(oq, order);
+        }
+    }
+    free(oq);
+}
@@ -0,0 +1,37 @@
+#ifndef ORDER_QUEUE_H
+#define ORDER_QUEUE_H
+
+#include <stdlib.h>
+
+/**
+ * Waiting jobs bucketed by buddy order (the block they need is 2^order bytes), FIFO
+ * within an order. A bitmask of the non-empty orders and an arrival sequence number per
+ * entry let the admission policies find the best-fitting or the oldest waiting job in
+ * O(orders) instead of scanning every waiting job.
+ */
+#define ORDER_QUEUE_ORDERS 32
+
+typedef struct OrderEntry {
+    void* item;
+    long long seq; // arrival sequence number, lower is older
+    int since;     // time the item started waiting
+    struct OrderEntry* next;
+} OrderEntry;
+
+typedef struct {
+    OrderEntry* first[ORDER_QUEUE_ORDERS]; // per order, oldest entry
+    OrderEntry* last[ORDER_QUEUE_ORDERS];  // per order, newest entry
+    unsigned int orders;                   // bit k set when order k has an entry
+    long long next_seq;
+    int size;
+} OrderQueue;
+
+OrderQueue* order_queue(void);
+void oq_push(OrderQueue* oq, void* item, int order, int since);
+OrderEntry* oq_front(const OrderQueue* oq, int order);
+void* oq_remove(OrderQueue* oq, int order, OrderEntry* prev);
+void* oq_pop(OrderQueue* oq, int order);
+int oq_size(const OrderQueue* oq);
+void oq_free(OrderQueue* oq);
+
+#endif /* ORDER_QUEUE_H */
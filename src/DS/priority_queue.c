@@ -1,6 +1,7 @@
 #include "priority_queue.h"
 #include <stdio.h>
 #include "../process.h"
+#include "../logger.h"
 
 /**
  * @brief Create a new priority queue
@@ -26,7 +27,7 @@ PriorityQueue* priority_queue() {
  * @param[in] item Pointer to the item itself to enqueue
  * @return void
  */
-void pq_enqueue(PriorityQueue* pq, void* item, int priority) {
+void pq_enqueue(PriorityQueue* pq, void* item, long long priority) {
     // create new node
     PQueueNode* newNode = (PQueueNode*)malloc(sizeof(PQueueNode));
     newNode->item = item;
@@ -36,7 +37,7 @@ void pq_enqueue(PriorityQueue* pq, void* item, int priority) {
 
     // check capacity first 
     if (pq->size == pq->capacity) {
-        printf("size %d capacity: %d\n", pq->size, pq->capacity);
+        LOG_TRACE("size %d capacity: %d\n", pq->size, pq->capacity);
 
         // double the init capacity
         pq->capacity = pq->capacity * 2;
@@ -45,11 +46,11 @@ void pq_enqueue(PriorityQueue* pq, void* item, int priority) {
         pq->nodes = realloc(pq->nodes, pq->capacity * sizeof(PQueueNode*));
 
         if (pq->nodes == NULL) {
-            fprintf(stderr, "Error: Failed to realloc memory for priority queue.\n");
+            LOG_ERROR("Error: Failed to realloc memory for priority queue.\n");
         }
     }
 
-    printf("process %d added to queue\n", ((Process*)item)->id);
+    LOG_TRACE("process %d added to queue\n", ((Process*)item)->id);
     // insert new item
     pq->nodes[pq->size] = newNode;
     pq->size++;
@@ -70,7 +71,7 @@ void pq_enqueue(PriorityQueue* pq, void* item, int priority) {
         }
     }
 
-    printf("top process: %d\n", ((Process*)pq->nodes[0]->item)->id);
+    LOG_TRACE("top process: %d\n", ((Process*)pq->nodes[0]->item)->id);
 }
 
 
@@ -119,7 +120,7 @@ void* pq_front(PriorityQueue* pq) {
  * @return Positive if item1 > item2, negative if item1 < item2, zero if equal
  */
 int compare_priority(PQueueNode* a, PQueueNode* b) {
-    return a->priority - b->priority;
+    return (a->priority > b->priority) - (a->priority < b->priority);
 }
 
 /**
@@ -207,15 +208,15 @@ void pq_free(PriorityQueue* pq) {
  * @param[in] new_priority New priority value to set
  * @return void
  */
-void pq_change_priority(PriorityQueue* pq, int index, int new_priority) {
+void pq_change_priority(PriorityQueue* pq, int index, long long new_priority) {
     // Check if index is valid
     if (index < 0 || index >= pq->size) {
-        fprintf(stderr, "Error: Index out of bounds for priority queue.\n");
+        LOG_ERROR("Error: Index out of bounds for priority queue.\n");
         return;
     }
     
     // Get the old priority
-    int old_priority = pq->nodes[index]->priority;
+    long long old_priority = pq->nodes[index]->priority;
     
     // Update to the new priority (inverted to maintain min-heap property)
     pq->nodes[index]->priority = -new_priority;
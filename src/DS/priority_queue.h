@@ -6,7 +6,7 @@
 
 typedef struct {
     void* item;
-    int priority;
+    long long priority;
 } PQueueNode;
 
 typedef struct {
@@ -16,7 +16,7 @@ typedef struct {
 } PriorityQueue;
 
 PriorityQueue* priority_queue();
-void pq_enqueue(PriorityQueue* pq, void* item, int priority);
+void pq_enqueue(PriorityQueue* pq, void* item, long long priority);
 void* pq_dequeue(PriorityQueue* pq);
 void* pq_front(PriorityQueue* pq);
 
@@ -26,7 +26,7 @@ bool pq_is_empty(PriorityQueue* pq);
 int compare_priority(PQueueNode* a, PQueueNode* b);
 void pq_swap(PQueueNode** a, PQueueNode** b);
 void pq_heapify(PriorityQueue* pq, int i);
-void pq_change_priority(PriorityQueue* pq, int index, int new_priority);
+void pq_change_priority(PriorityQueue* pq, int index, long long new_priority);
 
 void pq_free(PriorityQueue* pq);
 
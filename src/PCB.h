@@ -3,6 +3,15 @@
 
 #include "process.h"
 #include "buddy_memory.h"
+
+// Where the memory of a process is (engine only)
+typedef enum SwapState {
+    SWAP_RESIDENT, // in memory
+    SWAP_OUT,      // being written to the swap device, still holds its memory
+    SWAP_SWAPPED,  // on the swap device, holds no memory
+    SWAP_IN        // being read back into the memory it holds again
+} SwapState;
+
 // PCB represents the runtime state of a process
 typedef struct PCB
 {
@@ -15,8 +24,31 @@ typedef struct PCB
     int start_time;
     int wait_time;
     int remaining_time; // initially set to runtime
+    int predicted_runtime; // burst estimate when runtime prediction is on (-E), 0 when the true runtime is used
     char* state;
 
+    // Multi-CPU (engine only)
+    int last_cpu;      // CPU of the last run, -1 before the first dispatch
+    double work_carry; // fraction of a work unit done but not taken off remaining_time yet
+    int run_time;      // ticks spent running, differs from the work done on CPUs of speed other than 1
+    int node;          // memory node of memory_block, -1 without memory
+
+    // I/O bursts (engine only)
+    int io_next;    // next entry of PDATA.io to issue
+    int io_time;    // ticks spent blocked on devices (queued or served), not counted as waiting
+    int blocked_at; // time of the pending I/O request
+
+    // Swapping (engine only)
+    SwapState swap_state;
+    int swap_pinned; // got memory and has not run since, never a swap-out victim
+    int swapped_at;  // start of the last swap-out
+    int swap_count;  // times swapped out
+
+    // Proportional share (lottery, stride)
+    long long pass;          // stride: virtual time at which the process is next due
+    double share_start;      // fair share clock when the process became ready
+    double intended_service; // CPU time it was entitled to, set when it finishes (0 otherwise)
+
     Block * memory_block;
 
     struct Process PDATA; // data of process read by input file
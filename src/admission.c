@@ -0,0 +1,109 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "admission.h"
+
+static const char* admit_policy_names[] = { "oldest", "best", "largest", "aging" };
+
+const char* admit_policy_name(AdmitPolicy policy) {
+    return admit_policy_names[policy];
+}
+
+/**
+ * @brief Parse "<policy>[,age=<ticks>]", the memory admission policy
+ * @details age only applies to aging and defaults to 100 ticks.
+ *
+ * @return int 0 for success, 1 for an unknown policy or option or an invalid value
+ */
+int parse_admit_policy(const char* spec, AdmitConfig* config) {
+    char* copy = strdup(spec);
+    if (copy == NULL) {
+        return 1;
+    }
+
+    config->age = 100;
+
+    char* save = NULL;
+    char* item = strtok_r(copy, ",", &save);
+    int status = 1;
+    for (int i = 0; item != NULL && i < (int)(sizeof(admit_policy_names) / sizeof(admit_policy_names[0])); i++) {
+        if (strcmp(item, admit_policy_names[i]) == 0) {
+            config->policy = (AdmitPolicy)i;
+            status = 0;
+        }
+    }
+
+    while (status == 0 && (item = strtok_r(NULL, ",", &save)) != NULL) {
+        char* end;
+        long age = strncmp(item, "age=", 4) == 0 ? strtol(item + 4, &end, 10) : -1;
+        if (config->policy != ADMIT_AGING || age < 1 || age > INT_MAX || item[4] == '\0' || *end != '\0') {
+            status = 1;
+            break;
+        }
+        config->age = (int)age;
+    }
+
+    free(copy);
+    return status;
+}
+
+/**
+ * @brief Order of the next process to admit
+ * @details heads[k] is the oldest process of order k still to consider, for each order in
+ *          `waiting`. Best fit picks the order leaving the smallest gap to the smallest free
+ *          block that holds it, the larger order on a tie. Aging does the same unless the
+ *          oldest process has waited `age` ticks: then it is the only candidate and *held
+ *          tells the caller not to give memory to anyone else meanwhile. Orders above `top`
+ *          never fit and are never considered, so they cannot hold the admissions forever.
+ *
+ * @param[in] free bit k set when a free block of order k exists
+ * @param[in] top order of the whole memory
+ * @param[out] held 1 when an aged process holds the admissions
+ *
+ * @return int the order, -1 when no process to consider fits
+ */
+int admit_pick(const AdmitConfig* config, OrderEntry* const* heads, unsigned int waiting, unsigned int free,
+    int top, int time, int* held) {
+    *held = 0;
+    waiting &= top >= 31 ? ~0u : (2u << top) - 1;
+    if (waiting == 0 || free == 0) {
+        return -1;
+    }
+    unsigned int largest_free = 31 - __builtin_clz(free);
+    unsigned int fits = waiting & (largest_free >= 31 ? ~0u : (2u << largest_free) - 1);
+
+    if (config->policy == ADMIT_OLDEST || config->policy == ADMIT_AGING) {
+        unsigned int candidates = config->policy == ADMIT_OLDEST ? fits : waiting;
+        int oldest = -1;
+        for (unsigned int orders = candidates; orders != 0; orders &= orders - 1) {
+            int order = __builtin_ctz(orders);
+            if (oldest < 0 || heads[order]->seq < heads[oldest]->seq) {
+                oldest = order;
+            }
+        }
+        if (config->policy == ADMIT_OLDEST) {
+            return oldest;
+        }
+        if (time - heads[oldest]->since >= config->age) {
+            *held = 1;
+            return (fits >> oldest) & 1 ? oldest : -1;
+        }
+    }
+
+    if (config->policy == ADMIT_LARGEST) {
+        return fits != 0 ? 31 - __builtin_clz(fits) : -1;
+    }
+
+    int best = -1;
+    int best_gap = 0;
+    for (unsigned int orders = fits; orders != 0; orders &= orders - 1) {
+        int order = __builtin_ctz(orders);
+        int gap = __builtin_ctz(free >> order);
+        if (best < 0 || gap <= best_gap) {
+            best = order;
+            best_gap = gap;
+        }
+    }
+    return best;
+}
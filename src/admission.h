@@ -0,0 +1,30 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include "DS/order_queue.h"
+
+/**
+ * Memory admission: which process waiting for memory gets a block when memory is freed.
+ * Waiting processes are kept by the buddy order of the block they need (see order_queue.h)
+ * and the policy picks an order that fits one of the free blocks, the oldest process of that
+ * order goes first. A process of order k fits when a free block of order k or more exists.
+ */
+
+typedef enum AdmitPolicy {
+    ADMIT_OLDEST,  // oldest waiting process that fits
+    ADMIT_BEST,    // fits the smallest free block most tightly, splitting the fewest blocks
+    ADMIT_LARGEST, // largest waiting process that fits
+    ADMIT_AGING    // best fit, but a process waiting `age` ticks or more holds all admissions until it fits
+} AdmitPolicy;
+
+typedef struct AdmitConfig {
+    AdmitPolicy policy;
+    int age; // aging: ticks of waiting before the oldest process holds the memory
+} AdmitConfig;
+
+int parse_admit_policy(const char* spec, AdmitConfig* config);
+const char* admit_policy_name(AdmitPolicy policy);
+int admit_pick(const AdmitConfig* config, OrderEntry* const* heads, unsigned int waiting, unsigned int free,
+    int top, int time, int* held);
+
+#endif /* ADMISSION_H */
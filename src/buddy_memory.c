@@ -2,22 +2,33 @@
 #include <stdlib.h>
 #include <math.h>
 #include "buddy_memory.h"
+#include "logger.h"
 
-Block *memo;
 /**
  * @brief Initialize memory structure.
  *
  * @return Block* Pointer to memory block.
  */
 Block *init_memory()
+{
+    return init_memory_size(MAX_SIZE);
+}
+
+/**
+ * @brief Initialize memory structure of a given size.
+ *
+ * @param[in] size total memory size (power of two)
+ *
+ * @return Block* Pointer to memory block.
+ */
+Block *init_memory_size(int size)
 {
     Block *memory = (Block *)malloc(sizeof(Block));
-    memory->size = MAX_SIZE;
+    memory->size = size;
     memory->start = 0;
     memory->next = NULL;
     memory->prev = NULL;
     memory->allocated = 0;
-    memo = memory;
     return memory;
 }
 
@@ -125,7 +136,6 @@ void merge_block(Block *block)
             {
                 buddy->next->prev = block;
             }
-                print_memo(memo);
             free(buddy);
             merge_block(block);
         }
@@ -160,7 +170,7 @@ void deallocate_memory(Block *block)
     // Check if block exists
     if (block == NULL)
     {
-        printf("Deallocating failed: no such a block!\n");
+        LOG_ERROR("Deallocating failed: no such a block!\n");
         return;
     }
 
@@ -184,8 +194,40 @@ void print_memo(Block *memory)
     Block *current = memory;
     while (current != NULL)
     {
-        printf("start: %d, size: %d, allocated: %d\n", current->start, current->size, current->allocated);
+        LOG_DEBUG("start: %d, size: %d, allocated: %d\n", current->start, current->size, current->allocated);
         current = current->next;
     }
-    printf("Done printing memory\n");
+    LOG_DEBUG("Done printing memory\n");
+}
+
+/**
+ * @brief Buddy order of a request: the smallest k with 2^k >= size
+ *
+ * @param[in] size size of memory to be allocated
+ *
+ * @return int the order of the block the request gets
+ */
+int block_order(int size)
+{
+    return size <= 1 ? 0 : 32 - __builtin_clz((unsigned int)(size - 1));
+}
+
+/**
+ * @brief Orders that have a free block
+ *
+ * @param[in] memory pointer to memory
+ *
+ * @return unsigned int bit k set when a free block of 2^k bytes exists
+ */
+unsigned int free_orders(Block *memory)
+{
+    unsigned int orders = 0;
+    for (Block *current = memory; current != NULL; current = current->next)
+    {
+        if (current->allocated == 0)
+        {
+            orders |= 1u << block_order(current->size);
+        }
+    }
+    return orders;
 }
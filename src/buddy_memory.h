@@ -12,6 +12,7 @@ typedef struct Block {
 } Block;
 
 Block *init_memory();
+Block *init_memory_size(int size);
 Block *get_smallest_block_available(Block *memory, int size);
 void split_block(Block *block);
 Block *allocate_memory(Block *memory, int size);
@@ -19,5 +20,7 @@ void merge_block(Block *block);
 void deallocate_memory(Block *block);
 void destroy_memory(Block *memory);
 void print_memo(Block *memory);
+int block_order(int size);
+unsigned int free_orders(Block *memory);
 
 #endif //BUDDY_MEMORY_H
\ No newline at end of file
@@ -9,15 +9,19 @@
 #include <stdio.h>
 #include <signal.h>
 #include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include "clk.h"
 
-#define SHKEY 300
 ///==============================
 // don't mess with this variable//
 int *shmaddr = NULL; //
 //===============================
 
-int shmid;
+int shmid = -1;
 
 /* Clear the resources before exit */
 void _cleanup(__attribute__((unused)) int signum)
@@ -27,25 +31,35 @@ void _cleanup(__attribute__((unused)) int signum)
     exit(0);
 }
 
-void init_clk()
+void create_clk()
 {
-    printf("Clock starting\n");
-    signal(SIGINT, _cleanup);
-    int clk = 0;
-    // Create shared memory for one integer variable 4 bytes
-    shmid = shmget(SHKEY, 4, IPC_CREAT | 0644);
+    // Private segment: only this run (the creator and its forked children) can reach it
+    shmid = shmget(IPC_PRIVATE, 4, IPC_CREAT | 0600);
     if ((long)shmid == -1)
     {
         perror("Error in creating shm!");
         exit(-1);
     }
-    int *shmaddr = (int *)shmat(shmid, (void *)0, 0);
+    shmaddr = (int *)shmat(shmid, (void *)0, 0);
     if ((long)shmaddr == -1)
     {
-        perror("Error in attaching the shm in clock!");
+        perror("Error in attaching the shm!");
         exit(-1);
     }
-    *shmaddr = clk; /* initialize shared memory */
+    *shmaddr = 0;
+    // Destroyed automatically once the last process of the run detaches, even after a crash
+    shmctl(shmid, IPC_RMID, NULL);
+}
+
+void init_clk()
+{
+    printf("Clock starting\n");
+    signal(SIGINT, _cleanup);
+    if (shmaddr == NULL)
+    {
+        create_clk();
+    }
+    *shmaddr = 0; /* initialize shared memory */
 }
 
 void run_clk()
@@ -54,6 +68,8 @@ void run_clk()
     {
         sleep(1);
         (*shmaddr)++;
+        // Wake every process blocked in wait_for_clk()
+        syscall(SYS_futex, shmaddr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
        // printf("Current time: %d\n", *shmaddr); // TODO delete this line
     }
 }
@@ -63,17 +79,31 @@ int get_clk()
     return *shmaddr;
 }
 
+int wait_for_clk(int time)
+{
+    // Safety net in case the clock dies while we are blocked
+    struct timespec timeout = {1, 0};
+
+    int now = get_clk();
+    while (now < time)
+    {
+        if (syscall(SYS_futex, shmaddr, FUTEX_WAIT, now, &timeout, NULL, 0) == -1 && errno == EINTR)
+        {
+            return get_clk();
+        }
+        now = get_clk();
+    }
+    return now;
+}
+
 void sync_clk()
 {
-    int shmid = shmget(SHKEY, 4, 0444);
-    while ((int)shmid == -1)
+    // The segment is attached by create_clk() and inherited across fork
+    if (shmaddr == NULL)
     {
-        // Make sure that the clock exists
-        printf("Wait! The clock not initialized yet!\n");
-        sleep(1);
-        shmid = shmget(SHKEY, 4, 0444);
+        fprintf(stderr, "The clock is not initialized, call create_clk() before forking!\n");
+        exit(-1);
     }
-    shmaddr = (int *)shmat(shmid, (void *)0, 0);
 }
 
 void destroy_clk(short terminateAll)
@@ -1,9 +1,15 @@
 #ifndef CLK_H
 #define CLK_H
 
+/*
+ * This function creates the clock of this run: a private shared memory segment
+ * holding the clock value. Call it once before forking the clock and the processes
+ * that read it; they inherit the segment, so concurrent runs never share a clock.
+ */
+void create_clk();
 /*
  * This function is used to initialize the clock module.
- * It creates a shared memory segment and initializes the clock value to 0.
+ * It initializes the clock value to 0 (creating the segment if needed).
  */
 void init_clk();
 /*
@@ -15,8 +21,16 @@ void run_clk();
  *This function is used to get the clock value from the shared memory
  */
 int get_clk();
+/*
+ * This function blocks until the clock value reaches the given time.
+ * It sleeps on the shared clock value instead of polling and returns early
+ * when a signal interrupts the wait.
+ * Output: the clock value on return.
+ */
+int wait_for_clk(int time);
 /*
  * All process call this function at the beginning to establish communication between them and the clock module.
+ * It checks that the segment created by create_clk() is attached.
  * Again, remember that the clock is only emulation!
  */
 void sync_clk();
@@ -0,0 +1,155 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "disk.h"
+
+static const char* disk_policy_names[] = { "fcfs", "sstf", "scan", "cscan", "look", "clook" };
+
+const char* disk_policy_name(DiskPolicy policy) {
+    return disk_policy_names[policy];
+}
+
+/**
+ * @brief Parse "<policy>[,cylinders=<n>][,seek=<ticks per cylinder>][,settle=<ticks>][,rotation=<ticks>]"
+ * @details Defaults: 200 cylinders, 0.05 ticks per cylinder, 1 tick settle, 4 tick rotation.
+ *
+ * @return int 0 for success, 1 for an unknown policy or option or an invalid value
+ */
+int parse_disk_model(const char* spec, DiskModel* model) {
+    char* copy = strdup(spec);
+    if (copy == NULL) {
+        return 1;
+    }
+
+    model->cylinders = 200;
+    model->seek_per_cylinder = 0.05;
+    model->settle = 1;
+    model->rotation = 4;
+
+    char* save = NULL;
+    char* item = strtok_r(copy, ",", &save);
+    int status = 1;
+    for (int i = 0; item != NULL && i < (int)(sizeof(disk_policy_names) / sizeof(disk_policy_names[0])); i++) {
+        if (strcmp(item, disk_policy_names[i]) == 0) {
+            model->policy = (DiskPolicy)i;
+            status = 0;
+        }
+    }
+
+    while (status == 0 && (item = strtok_r(NULL, ",", &save)) != NULL) {
+        char* value = strchr(item, '=');
+        if (value == NULL) {
+            status = 1;
+            break;
+        }
+        *value++ = '\0';
+
+        char* end;
+        double number = strtod(value, &end);
+        if (*value == '\0' || *end != '\0' || number < 0 || number > INT_MAX) {
+            status = 1;
+        }
+        else if (strcmp(item, "cylinders") == 0 && number >= 1 && number == (int)number) {
+            model->cylinders = (int)number;
+        }
+        else if (strcmp(item, "seek") == 0) {
+            model->seek_per_cylinder = number;
+        }
+        else if (strcmp(item, "settle") == 0 && number == (int)number) {
+            model->settle = (int)number;
+        }
+        else if (strcmp(item, "rotation") == 0 && number == (int)number) {
+            model->rotation = (int)number;
+        }
+        else {
+            status = 1;
+        }
+    }
+
+    free(copy);
+    return status;
+}
+
+/**
+ * @brief Move the head straight to `cylinder` (FCFS)
+ *
+ * @return int cylinders crossed
+ */
+int disk_move(DiskHead* head, int cylinder) {
+    int distance = abs(cylinder - head->cylinder);
+    if (cylinder != head->cylinder) {
+        head->direction = cylinder > head->cylinder ? 1 : -1;
+    }
+    head->cylinder = cylinder;
+    return distance;
+}
+
+/**
+ * @brief Pick the cylinder the head serves next and move the head there
+ * @details Not for FCFS, whose order is not by cylinder. The queue must not be empty.
+ *
+ * @param[out] distance cylinders crossed, including the sweep to the edge of the disk
+ *             (SCAN, C-SCAN) and the return sweep (C-SCAN, C-LOOK)
+ *
+ * @return int the cylinder, the caller pops its oldest request
+ */
+int disk_next(const DiskModel* model, DiskQueue* queue, DiskHead* head, int* distance) {
+    int h = head->cylinder;
+    int top = model->cylinders - 1;
+    int next;
+
+    switch (model->policy) {
+    case DISK_SSTF: {
+        int up = dq_ceiling(queue, h);
+        int down = dq_floor(queue, h);
+        if (up < 0 || (down >= 0 && (h - down < up - h || (h - down == up - h && head->direction < 0)))) {
+            next = down;
+        }
+        else {
+            next = up;
+        }
+        *distance = disk_move(head, next);
+        return next;
+    }
+    case DISK_SCAN:
+    case DISK_LOOK:
+        next = head->direction > 0 ? dq_ceiling(queue, h) : dq_floor(queue, h);
+        if (next >= 0) {
+            *distance = abs(next - h);
+        }
+        else {
+            // Nothing left ahead: reverse, SCAN first travels to the edge of the disk
+            int edge = head->direction > 0 ? top : 0;
+            head->direction = -head->direction;
+            next = head->direction > 0 ? dq_ceiling(queue, h) : dq_floor(queue, h);
+            *distance = model->policy == DISK_SCAN ? abs(edge - h) + abs(edge - next) : abs(next - h);
+        }
+        break;
+    default: // DISK_CSCAN, DISK_CLOOK
+        head->direction = 1;
+        next = dq_ceiling(queue, h);
+        if (next >= 0) {
+            *distance = next - h;
+        }
+        else {
+            // Return to the start: C-SCAN sweeps to the edge and back to cylinder 0
+            next = dq_ceiling(queue, 0);
+            *distance = model->policy == DISK_CSCAN ? (top - h) + top + next : h - next;
+        }
+        break;
+    }
+
+    head->cylinder = next;
+    return next;
+}
+
+/**
+ * @brief Service ticks of a request: seek, rotational latency and one tick of transfer
+ */
+int disk_service_time(const DiskModel* model, int distance, Rng* rng) {
+    int seek = distance > 0 ? model->settle + (int)ceil(distance * model->seek_per_cylinder) : 0;
+    int latency = model->rotation > 0 ? (int)(rng_next(rng) % (uint64_t)model->rotation) : 0;
+    return seek + latency + 1;
+}
@@ -0,0 +1,42 @@
+#ifndef DISK_H
+#define DISK_H
+
+#include "DS/disk_queue.h"
+#include "workload.h"
+
+/**
+ * Simulated disk: requests name a cylinder and the request queue policy picks which
+ * pending request the head serves next. A request costs the seek (settle time plus a
+ * time per cylinder crossed), a random rotational latency and one tick of transfer.
+ */
+
+typedef enum DiskPolicy {
+    DISK_FCFS,  // arrival order
+    DISK_SSTF,  // nearest cylinder first
+    DISK_SCAN,  // sweep to the last cylinder, then back (elevator)
+    DISK_CSCAN, // sweep up to the last cylinder, return to cylinder 0
+    DISK_LOOK,  // sweep only as far as the last request, then back
+    DISK_CLOOK  // sweep up to the last request, jump back to the lowest request
+} DiskPolicy;
+
+typedef struct DiskModel {
+    DiskPolicy policy;
+    int cylinders;            // cylinders 0 .. cylinders - 1
+    double seek_per_cylinder; // seek ticks per cylinder crossed
+    int settle;               // ticks of any non-zero seek
+    int rotation;             // ticks of one rotation, the latency is uniform in [0, rotation)
+} DiskModel;
+
+// Head position and sweep direction of one disk
+typedef struct DiskHead {
+    int cylinder;
+    int direction; // 1 towards higher cylinders, -1 towards lower
+} DiskHead;
+
+int parse_disk_model(const char* spec, DiskModel* model);
+const char* disk_policy_name(DiskPolicy policy);
+int disk_next(const DiskModel* model, DiskQueue* queue, DiskHead* head, int* distance);
+int disk_move(DiskHead* head, int cylinder);
+int disk_service_time(const DiskModel* model, int distance, Rng* rng);
+
+#endif /* DISK_H */
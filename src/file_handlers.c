@@ -1,25 +1,113 @@
+#include <limits.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
 #include "clk.h"
 
 #include "file_handlers.h"
 #include "PCB.h"
+#include "stats.h"
+#include "workload.h"
+#include "io_device.h"
+#include "task_group.h"
+#include "Algorithms/policy.h"
 
 FILE* scheduler_log = NULL; // File to log execution events
-double total_WTA = 0;
 
 FILE* scheduler_perf = NULL; // File to log execution events
-int total_wait = 0;
-int proc_count;
-double* WTAs;
+PerfStats perf_stats;        // Streaming accumulators of finished processes
+PerfStats window_stats;      // Same accumulators for the current rolling report window
+JobTable finished_jobs;      // Columnar table of finished processes for the end-of-run breakdowns
 
 FILE* memory_log = NULL; // File to log memory events
 
+/**
+ * @brief Read a binary workload file (see workload.h) after its magic number
+ *
+ * @return int 0 for success, 1 for error
+ */
+static int read_binary_input(FILE* file, Process** process_list, int* process_count) {
+    WorkloadHeader header;
+    rewind(file);
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.version != WORKLOAD_VERSION) {
+        fprintf(stderr, "Error: unsupported binary workload file\n");
+        return 1;
+    }
+
+    // The header must not promise more records than the file holds
+    long start = ftell(file);
+    if (start < 0 || fseek(file, 0, SEEK_END) != 0) {
+        perror("Error reading file");
+        return 1;
+    }
+    long end = ftell(file);
+    if (end < 0 || fseek(file, start, SEEK_SET) != 0) {
+        perror("Error reading file");
+        return 1;
+    }
+    if (header.count > INT_MAX || header.count > (uint64_t)(end - start) / sizeof(WorkloadRecord)) {
+        fprintf(stderr, "Error: binary workload file header counts %llu processes, the file is too short or the count too large\n",
+                (unsigned long long)header.count);
+        return 1;
+    }
+
+    *process_list = malloc((header.count > 0 ? header.count : 1) * sizeof(Process));
+    if (*process_list == NULL) {
+        perror("Error allocating memory");
+        return 1;
+    }
+
+    WorkloadRecord records[1024];
+    uint64_t read_count = 0;
+    while (read_count < header.count) {
+        size_t batch = header.count - read_count < 1024 ? header.count - read_count : 1024;
+        if (fread(records, sizeof(WorkloadRecord), batch, file) != batch) {
+            fprintf(stderr, "Error: truncated binary workload file\n");
+            free(*process_list);
+            *process_list = NULL;
+            return 1;
+        }
+
+        for (size_t i = 0; i < batch; i++) {
+            Process* proc = &(*process_list)[read_count + i];
+            proc->id = records[i].id;
+            proc->arrival_time = records[i].arrival_time;
+            proc->runtime = records[i].runtime;
+            proc->priority = records[i].priority;
+            proc->memory_size = records[i].memory_size;
+            proc->deadline = records[i].deadline > 0 ? records[i].arrival_time + records[i].deadline : 0;
+            proc->period = 0;
+            proc->io = NULL;
+            proc->io_count = 0;
+            proc->group = 0;
+            proc->affinity = 0;
+        }
+        read_count += batch;
+    }
+
+    *process_count = (int)header.count;
+    return 0;
+}
+
+/**
+ * @brief Parse a CPU affinity mask, e.g. "0x3" or "3" for CPUs 0 and 1
+ *
+ * @return int 0 for success, 1 for an invalid or empty mask
+ */
+static int parse_affinity(const char* spec, unsigned int* affinity) {
+    char* end;
+    unsigned long mask = strtoul(spec, &end, 0);
+    if (*spec == '-' || *end != '\0' || mask == 0 || mask > UINT_MAX) {
+        return 1;
+    }
+    *affinity = (unsigned int)mask;
+    return 0;
+}
+
 // exit code 0 for success, 1 for error
 int read_input_file(const char* filename, Process** process_list, int* process_count) {
-    FILE* file = fopen(filename, "r");
+    FILE* file = fopen(filename, "rb");
     if (file == NULL) {
         perror("Error opening file");
         return 1;
@@ -28,8 +116,19 @@ int read_input_file(const char* filename, Process** process_list, int* process_c
     *process_list = NULL;
     *process_count = 0;
 
+    // Binary workload files start with a magic number, text files with a digit or '#'
+    uint32_t magic = 0;
+    if (fread(&magic, sizeof(magic), 1, file) == 1 && magic == WORKLOAD_MAGIC) {
+        int status = read_binary_input(file, process_list, process_count);
+        fclose(file);
+        return status;
+    }
+    rewind(file);
+
+    int capacity = 0;
+
     while (1) {
-        char line[256];
+        char line[1024];
         if (fgets(line, sizeof(line), file) == NULL)
             break;
 
@@ -37,29 +136,56 @@ int read_input_file(const char* filename, Process** process_list, int* process_c
         if (line[0] == '#' || line[0] == '\n')
             continue;
 
-        // Re-alloc the array memroy for the new process
-        Process* temp = realloc(*process_list, (*process_count + 1) * sizeof(Process));
+        // Grow the array geometrically when full
+        if (*process_count == capacity) {
+            capacity = capacity == 0 ? 64 : capacity * 2;
+            Process* temp = realloc(*process_list, capacity * sizeof(Process));
 
-        if (temp == NULL) {
-            perror("Error reallocating memory");
-            free(*process_list);
-            fclose(file);
-            return 1;
+            if (temp == NULL) {
+                perror("Error reallocating memory");
+                free_process_list(*process_list, *process_count);
+                fclose(file);
+                return 1;
+            }
+
+            // Update array memory
+            *process_list = temp;
         }
 
-        // Update array size
-        *process_list = temp;
+        // Use sscanf to parse tab-separated values, the sixth (relative deadline), seventh
+        // (CPU / I/O burst list, "-" for a single CPU burst), eighth (group, "-" for the default
+        // group) and ninth (CPU affinity mask) columns are optional
+        Process* proc = &(*process_list)[*process_count];
+        int relative_deadline = 0;
+        int consumed = 0;
+        int fields = sscanf(line, "%d\t%d\t%d\t%d\t%d\t%d%n",
+            &proc->id,
+            &proc->arrival_time,
+            &proc->runtime,
+            &proc->priority,
+            &proc->memory_size,
+            &relative_deadline,
+            &consumed);
+        proc->io = NULL;
+        proc->io_count = 0;
+        proc->group = 0;
+        proc->affinity = 0;
 
-        // Use sscanf to parse tab-separated values
-        if (sscanf(line, "%d\t%d\t%d\t%d\t%d",
-            &(*process_list)[*process_count].id,
-            &(*process_list)[*process_count].arrival_time,
-            &(*process_list)[*process_count].runtime,
-            &(*process_list)[*process_count].priority,
-            &(*process_list)[*process_count].memory_size) != 5) {
+        char bursts[1024] = "";
+        char group[1024] = "";
+        char affinity[1024] = "";
+        if (fields == 6) {
+            sscanf(line + consumed, "%1023s %1023s %1023s", bursts, group, affinity);
+        }
+        if ((fields != 5 && fields != 6) ||
+            (bursts[0] != '\0' && strcmp(bursts, "-") != 0 &&
+                parse_io_bursts(bursts, proc->runtime, &proc->io, &proc->io_count) != 0) ||
+            (group[0] != '\0' && strcmp(group, "-") != 0 && (proc->group = task_group_id(group)) < 0) ||
+            (affinity[0] != '\0' && parse_affinity(affinity, &proc->affinity) != 0)) {
 
             fprintf(stderr, "Error parsing line: %s", line);
-            free(*process_list);
+            free_process_list(*process_list, *process_count);
+            *process_list = NULL;
             fclose(file);
             return 1;
         }
@@ -77,13 +203,86 @@ int read_input_file(const char* filename, Process** process_list, int* process_c
         // (*process_list)[*process_count].start_time = -1;
         // (*process_list)[*process_count].wait_time = 0;
 
+        proc->deadline = relative_deadline > 0 ? proc->arrival_time + relative_deadline : 0;
+        proc->period = 0;
+
         (*process_count)++;
     }
 
-    // update processes count
-    proc_count = *process_count;
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief Free a process list read by read_input_file, with the I/O bursts of its processes
+ */
+void free_process_list(Process* process_list, int process_count) {
+    if (process_list == NULL) {
+        return;
+    }
+    for (int i = 0; i < process_count; i++) {
+        free(process_list[i].io);
+    }
+    free(process_list);
+}
+
+/**
+ * @brief Read a periodic task set: one "id phase wcet period memsize [deadline]" line per task
+ * @details The deadline is relative to each release and defaults to the period.
+ *
+ * @return int 0 for success, 1 for error
+ */
+int read_task_file(const char* filename, PeriodicTask** tasks, int* task_count) {
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) {
+        perror("Error opening task file");
+        return 1;
+    }
+
+    *tasks = NULL;
+    *task_count = 0;
+    int capacity = 0;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (line[0] == '#' || line[0] == '\n')
+            continue;
+
+        if (*task_count == capacity) {
+            capacity = capacity == 0 ? 16 : capacity * 2;
+            PeriodicTask* temp = realloc(*tasks, capacity * sizeof(PeriodicTask));
+            if (temp == NULL) {
+                perror("Error reallocating memory");
+                free(*tasks);
+                fclose(file);
+                return 1;
+            }
+            *tasks = temp;
+        }
+
+        PeriodicTask* task = &(*tasks)[*task_count];
+        task->deadline = 0;
+        int fields = sscanf(line, "%d\t%d\t%d\t%d\t%d\t%d",
+            &task->id, &task->phase, &task->wcet, &task->period, &task->memory_size, &task->deadline);
+        if (fields == 5 || task->deadline == 0) {
+            task->deadline = task->period;
+        }
+
+        if ((fields != 5 && fields != 6) || task->phase < 0 || task->wcet <= 0 || task->period <= 0 ||
+            task->memory_size <= 0 || task->deadline < 0 || task->deadline > task->period) {
+            fprintf(stderr, "Error parsing task (need phase >= 0, wcet > 0, 0 < deadline <= period): %s", line);
+            free(*tasks);
+            fclose(file);
+            return 1;
+        }
+        (*task_count)++;
+    }
 
     fclose(file);
+    if (*task_count == 0) {
+        fprintf(stderr, "Error: empty task file\n");
+        return 1;
+    }
     return 0;
 }
 
@@ -91,7 +290,9 @@ int read_input_file(const char* filename, Process** process_list, int* process_c
  * @brief Initialize scheduler.log file and print the header
  */
 void init_scheduler_log() {
-    WTAs = (double*)malloc(proc_count * sizeof(double));
+    perf_stats_init(&perf_stats);
+    perf_stats_init(&window_stats);
+    job_table_init(&finished_jobs);
 
     scheduler_log = fopen("scheduler.log", "w");
     if (scheduler_log == NULL) {
@@ -99,8 +300,7 @@ void init_scheduler_log() {
         exit(EXIT_FAILURE);
     }
 
-    fprintf(scheduler_log, "At time x process y state arr w total z remain y wait k\n");
-    fflush(scheduler_log);
+    write_scheduler_log_header(scheduler_log);
 }
 
 void init_memory_log() {
@@ -110,9 +310,19 @@ void init_memory_log() {
         exit(EXIT_FAILURE);
     }
 
-    fprintf(memory_log, "#At time x allocated y bytes for process z from i to j\n");
-    fflush(memory_log);
+    write_memory_log_header(memory_log);
 }
+
+void write_scheduler_log_header(FILE* log) {
+    fprintf(log, "At time x process y state arr w total z remain y wait k\n");
+    fflush(log);
+}
+
+void write_memory_log_header(FILE* log) {
+    fprintf(log, "#At time x allocated y bytes for process z from i to j\n");
+    fflush(log);
+}
+
 /**
  * @brief Log event into scheduler.log
  *
@@ -124,19 +334,53 @@ void log_event(PCB* pcb) {
         return;
     }
 
-
     int current_time = get_clk();
 
+    if (strcmp(pcb->state, "finished") == 0) {
+        Process process = pcb->PDATA;
+        int TA = current_time - process.arrival_time; // Calculate TA
+        double WTA = ((double)TA) / process.runtime;  // Calculate WTA
+        perf_stats_record(&perf_stats, TA, WTA, pcb->wait_time, pcb->start_time - process.arrival_time);
+        perf_stats_record(&window_stats, TA, WTA, pcb->wait_time, pcb->start_time - process.arrival_time);
+        if (job_table_push(&finished_jobs, process.arrival_time, pcb->start_time, current_time, process.runtime,
+            pcb->wait_time, process.priority, process.memory_size, process.deadline, pcb->intended_service) != 0) {
+            fprintf(stderr, "Error: failed to grow the finished job table\n");
+        }
+    }
+
+    write_event(scheduler_log, pcb, current_time);
+}
+
+/**
+ * @brief Count an admission control decision on a process whose deadline cannot be guaranteed
+ *
+ * @param[in] rejected 1 if the process was refused, 0 if it was only flagged
+ */
+void record_admission(int rejected) {
+    if (rejected) {
+        finished_jobs.rejected++;
+    }
+    else {
+        finished_jobs.flagged++;
+    }
+}
+
+/**
+ * @brief Write one scheduler.log line for a process state change
+ *
+ * @param[in] log scheduler log file
+ * @param[in] pcb process whose state changed
+ * @param[in] current_time time of the state change
+ */
+void write_event(FILE* log, PCB* pcb, int current_time) {
     Process process = pcb->PDATA;
     if (strcmp(pcb->state, "finished") == 0) {
 
         int TA = current_time - process.arrival_time; // Calculate TA
         double WTA = ((double)TA) / process.runtime;  // Calculate WTA
-        total_WTA += WTA;                         // Add WTA total WTA
-        total_wait += pcb->wait_time;
 
         char* wta_str = round_number(WTA); // Round and remove trailing zeros
-        fprintf(scheduler_log, "At time %d process %d %s arr %d total %d remain %d wait %d TA %d WTA %s\n",
+        fprintf(log, "At time %d process %d %s arr %d total %d remain %d wait %d TA %d WTA %s",
             current_time,
             process.id,
             pcb->state,
@@ -146,9 +390,20 @@ void log_event(PCB* pcb) {
             pcb->wait_time,
             TA,
             wta_str);
+        free(wta_str);
+
+        // Proportional share: fraction of its time in the system the process got the CPU, and was entitled to
+        if (pcb->intended_service > 0 && TA > 0) {
+            char* achieved_str = round_number((double)process.runtime / TA);
+            char* intended_str = round_number(pcb->intended_service / TA);
+            fprintf(log, " share %s of %s", achieved_str, intended_str);
+            free(achieved_str);
+            free(intended_str);
+        }
+        fprintf(log, "\n");
     }
     else {
-        fprintf(scheduler_log, "At time %d process %d %s arr %d total %d remain %d wait %d\n",
+        fprintf(log, "At time %d process %d %s arr %d total %d remain %d wait %d\n",
             current_time,
             process.id,
             pcb->state,
@@ -157,7 +412,7 @@ void log_event(PCB* pcb) {
             pcb->remaining_time,
             pcb->wait_time);
     }
-    fflush(scheduler_log);
+    fflush(log);
 }
 
 void log_memory_event(int pid, Block* block, int type) {
@@ -166,11 +421,22 @@ void log_memory_event(int pid, Block* block, int type) {
         return;
     }
 
-    int current_time = get_clk();
+    write_memory_event(memory_log, pid, block, type, get_clk());
+}
 
+/**
+ * @brief Write one memory.log line
+ *
+ * @param[in] log memory log file
+ * @param[in] pid process the block belongs to
+ * @param[in] block allocated / deallocated block
+ * @param[in] type 0 for deallocation, 1 for allocation
+ * @param[in] current_time time of the event
+ */
+void write_memory_event(FILE* log, int pid, Block* block, int type, int current_time) {
     if(type == 0) {
         // Deallocation
-        fprintf(memory_log, "At time %d deallocated %d bytes for process %d from %d to %d\n",
+        fprintf(log, "At time %d deallocated %d bytes for process %d from %d to %d\n",
             current_time,
             block->allocated,
             pid,
@@ -179,7 +445,7 @@ void log_memory_event(int pid, Block* block, int type) {
     }
     else if (type == 1) {
         // Allocation
-        fprintf(memory_log, "At time %d allocated %d bytes for process %d from %d to %d\n",
+        fprintf(log, "At time %d allocated %d bytes for process %d from %d to %d\n",
             current_time,
             block->allocated,
             pid,
@@ -191,27 +457,89 @@ void log_memory_event(int pid, Block* block, int type) {
         return;
     }
     
-    fflush(memory_log);
+    fflush(log);
+}
+/**
+ * @brief Print one metric's tail percentiles in scheduler.perf
+ *
+ * @param[in] perf scheduler.perf file
+ * @param[in] name metric name
+ * @param[in] hist histogram of the metric
+ */
+static void perf_percentiles_out(FILE* perf, const char* name, const Histogram* hist) {
+    static const double percentiles[] = { 50, 90, 99, 99.9 };
+    static const char* labels[] = { "p50", "p90", "p99", "p99.9" };
+
+    fprintf(perf, "%s", name);
+    for (int i = 0; i < 4; i++) {
+        char* value_str = round_number(histogram_percentile(hist, percentiles[i]));
+        fprintf(perf, " %s = %s", labels[i], value_str);
+        free(value_str);
+    }
+    fprintf(perf, "\n");
 }
+
 /**
  * @brief Calculate performance fields and print in scheduler.perf
  *
  * @param[in] int total_idle, int total_time
+ * @param[in] predictor runtime predictor of the run (its error statistics are printed when it is enabled)
  */
-void scheduler_perf_out(int total_idle, int total_time) {
-    double avg_wta = total_WTA / proc_count;             // Average WTA
-    double avg_wait = ((double)total_wait) / proc_count; // Average WTA
+void scheduler_perf_out(int total_idle, int total_time, const Predictor* predictor) {
+    // Open scheduler.perf file
+    scheduler_perf = fopen("scheduler.perf", "w");
+    if (scheduler_perf == NULL) {
+        perror("Failed to create scheduler perf file");
+        exit(EXIT_FAILURE);
+    }
 
-    double diff_square_sum = 0; // Variable to sum the square of differences for the std of WTA
+    write_perf(scheduler_perf, &perf_stats, &finished_jobs, total_idle, 0, total_time);
+    write_prediction_perf(scheduler_perf, predictor);
+    job_table_free(&finished_jobs);
+}
 
-    for (int i = 0; i < proc_count; i++) {
-        double diff = WTAs[i] - avg_wta;
-        diff_square_sum += diff * diff;
-    }
+/**
+ * @brief Print the averages of one breakdown group of scheduler.perf
+ *
+ * @param[in] perf output file
+ * @param[in] label group label, e.g. "Priority 3"
+ * @param[in] group sums of the group
+ */
+static void perf_group_out(FILE* perf, const char* label, const JobGroup* group) {
+    char* ta_str = round_number(group->ta_sum / group->count);
+    char* wta_str = round_number(group->wta_sum / group->count);
+    char* wait_str = round_number(group->wait_sum / group->count);
+    char* response_str = round_number(group->response_sum / group->count);
 
-    double std_wta = sqrt(diff_square_sum / proc_count);
+    fprintf(perf, "%s: count = %lld Avg TA = %s Avg WTA = %s Avg Waiting = %s Max Waiting = %d Avg Response = %s\n",
+        label, group->count, ta_str, wta_str, wait_str, group->wait_max, response_str);
 
-    double cpu_utilization = (1 - (((double)total_idle) / total_time)) * 100;
+    free(ta_str);
+    free(wta_str);
+    free(wait_str);
+    free(response_str);
+}
+
+/**
+ * @brief Write the performance fields of a run
+ *
+ * @param[in] perf output file
+ * @param[in] stats accumulators of the finished processes (percentiles)
+ * @param[in] jobs table of the finished processes (averages and breakdowns)
+ * @param[in] total_idle CPU idle time
+ * @param[in] total_overhead CPU time spent on switches, dispatches and allocations (engine cost model)
+ * @param[in] total_time simulation length
+ */
+void write_perf(FILE* perf, const PerfStats* stats, const JobTable* jobs, int total_idle, int total_overhead, int total_time) {
+    JobSummary summary;
+    job_table_summarize(jobs, &summary);
+
+    long long count = summary.all.count;
+    double avg_wta = count > 0 ? summary.all.wta_sum / count : 0;   // Average WTA
+    double avg_wait = count > 0 ? summary.all.wait_sum / count : 0; // Average Waiting
+    double std_wta = count > 0 ? sqrt(summary.wta_m2 / count) : 0;  // Std of WTA
+
+    double cpu_utilization = total_time > 0 ? (1 - (((double)total_idle) / total_time)) * 100 : 0;
 
     // Round and trim trailing zeros for all numbers
     char* cpu_utilization_str = round_number(cpu_utilization);
@@ -219,25 +547,476 @@ void scheduler_perf_out(int total_idle, int total_time) {
     char* avg_wait_str = round_number(avg_wait);
     char* std_wta_str = round_number(std_wta);
 
-    // Open scheduler.perf file
-    scheduler_perf = fopen("scheduler.perf", "w");
-    if (scheduler_perf == NULL) {
-        perror("Failed to create scheduler perf file");
-        exit(EXIT_FAILURE);
+    // Print to scheduler.perf file
+    fprintf(perf, "CPU utilization = %s%%\n", cpu_utilization_str);
+    if (total_overhead > 0) {
+        // The CPU is busy during overhead, but only the rest of the busy time runs processes
+        double effective = total_time > 0 ? (1 - ((double)(total_idle + total_overhead)) / total_time) * 100 : 0;
+        char* effective_str = round_number(effective);
+        fprintf(perf, "Overhead = %d Effective CPU utilization = %s%%\n", total_overhead, effective_str);
+        free(effective_str);
     }
+    fprintf(perf, "Avg WTA = %s\n", avg_wta_str);
+    fprintf(perf, "Avg Waiting = %s\n", avg_wait_str);
+    fprintf(perf, "Std WTA = %s\n", std_wta_str);
 
-    // Print to scheduler.perf file
-    fprintf(scheduler_perf, "CPU utilization = %s%\n", cpu_utilization_str);
-    fprintf(scheduler_perf, "Avg WTA = %s\n", avg_wta_str);
-    fprintf(scheduler_perf, "Avg Waiting = %s\n", avg_wait_str);
-    fprintf(scheduler_perf, "Std WTA = %s\n", std_wta_str);
-    fflush(scheduler_perf);
+    // Tail latencies
+    perf_percentiles_out(perf, "TA", &stats->ta_hist);
+    perf_percentiles_out(perf, "WTA", &stats->wta_hist);
+    perf_percentiles_out(perf, "Waiting", &stats->wait_hist);
+    perf_percentiles_out(perf, "Response", &stats->response_hist);
+
+    // Deadlines and admission control
+    if (summary.deadline_count > 0 || jobs->flagged > 0 || jobs->rejected > 0) {
+        double miss_ratio = summary.deadline_count > 0 ? 100.0 * summary.missed / summary.deadline_count : 0;
+        char* miss_ratio_str = round_number(miss_ratio);
+        char* avg_lateness_str = round_number(summary.deadline_count > 0 ? summary.lateness_sum / summary.deadline_count : 0);
+
+        fprintf(perf, "Deadlines = %lld Missed = %lld Miss ratio = %s%% Avg lateness = %s Max lateness = %d\n",
+            summary.deadline_count, summary.missed, miss_ratio_str, avg_lateness_str,
+            summary.deadline_count > 0 ? summary.lateness_max : 0);
+        fprintf(perf, "Admission flagged = %lld rejected = %lld\n", jobs->flagged, jobs->rejected);
+
+        free(miss_ratio_str);
+        free(avg_lateness_str);
+    }
+
+    // Proportional share: Jain's index of achieved / intended CPU time, then per ticket count
+    // the share of their time in the system the processes got versus were entitled to
+    char label[32];
+    if (summary.share_count > 0) {
+        char* jain_str = round_number(job_summary_jain_index(&summary));
+        char* class_jain_str = round_number(job_summary_class_jain_index(&summary));
+        char* ratio_str = round_number(summary.share_sum / summary.share_count);
+        fprintf(perf, "Share jobs = %lld Jain's fairness index = %s (per job) %s (per ticket count) Avg achieved / intended = %s\n",
+            summary.share_count, jain_str, class_jain_str, ratio_str);
+        free(jain_str);
+        free(class_jain_str);
+        free(ratio_str);
+
+        for (int i = 0; i < JOB_PRIORITY_CLASSES; i++) {
+            const JobGroup* group = &summary.by_priority[i];
+            if (group->count > 0 && group->ta_sum > 0) {
+                char* achieved_str = round_number(group->runtime_sum / group->ta_sum);
+                char* intended_str = round_number(group->intended_sum / group->ta_sum);
+                fprintf(perf, "Tickets %d: count = %lld Achieved share = %s Intended share = %s\n",
+                    SHARE_TICKET_LEVELS - i, group->count, achieved_str, intended_str);
+                free(achieved_str);
+                free(intended_str);
+            }
+        }
+    }
+
+    // Breakdowns by priority and by memory size class
+    for (int i = 0; i < JOB_PRIORITY_CLASSES; i++) {
+        if (summary.by_priority[i].count > 0) {
+            snprintf(label, sizeof(label), i == JOB_PRIORITY_CLASSES - 1 ? "Priority %d+" : "Priority %d", i);
+            perf_group_out(perf, label, &summary.by_priority[i]);
+        }
+    }
+    for (int i = 0; i < JOB_SIZE_CLASSES; i++) {
+        if (summary.by_size[i].count > 0) {
+            if (i == JOB_SIZE_CLASSES - 1) {
+                snprintf(label, sizeof(label), "Size %d+", 1 << i);
+            }
+            else {
+                snprintf(label, sizeof(label), "Size %d-%d", 1 << i, (2 << i) - 1);
+            }
+            perf_group_out(perf, label, &summary.by_size[i]);
+        }
+    }
+    fflush(perf);
 
     free(cpu_utilization_str);
     free(avg_wta_str);
     free(avg_wait_str);
     free(std_wta_str);
-    free(WTAs);
+}
+
+/**
+ * @brief Print the rolling report of the last window and start a new window
+ *
+ * @param[in] current_time time of the report
+ * @param[in] interval window length in ticks
+ * @param[in] queue_depth current ready queue size
+ */
+void rolling_report_out(int current_time, int interval, int queue_depth) {
+    double throughput = ((double)window_stats.ta.count) / interval;
+
+    printf("REPORT : t=%d throughput=%.2f/tick finished=%lld total=%lld queue=%d "
+        "TA p50=%.0f p99=%.0f WTA p50=%.2f p99=%.2f wait p99=%.0f\n",
+        current_time, throughput, window_stats.ta.count, perf_stats.ta.count, queue_depth,
+        histogram_percentile(&window_stats.ta_hist, 50),
+        histogram_percentile(&window_stats.ta_hist, 99),
+        histogram_percentile(&window_stats.wta_hist, 50),
+        histogram_percentile(&window_stats.wta_hist, 99),
+        histogram_percentile(&window_stats.wait_hist, 99));
+    fflush(stdout);
+
+    perf_stats_init(&window_stats);
+}
+
+/**
+ * @brief Append the generator's dispatch lag (send time - arrival time) to scheduler.perf
+ *
+ * @param[in] lag running statistic of the dispatch lag
+ * @param[in] lag_hist histogram of the dispatch lag
+ */
+void dispatch_perf_out(const RunningStat* lag, const Histogram* lag_hist) {
+    FILE* perf = fopen("scheduler.perf", "a");
+    if (perf == NULL) {
+        perror("Failed to open scheduler perf file");
+        return;
+    }
+
+    char* avg_str = round_number(lag->mean);
+    char* max_str = round_number(lag->max);
+    char* p99_str = round_number(histogram_percentile(lag_hist, 99));
+
+    fprintf(perf, "Dispatch lag avg = %s max = %s p99 = %s\n", avg_str, max_str, p99_str);
+    fclose(perf);
+
+    free(avg_str);
+    free(max_str);
+    free(p99_str);
+}
+
+/**
+ * @brief Write the runtime prediction error of a run, nothing when prediction is off
+ *
+ * @param[in] perf scheduler.perf file
+ * @param[in] predictor predictor of the run
+ */
+void write_prediction_perf(FILE* perf, const Predictor* predictor) {
+    if (!predictor_enabled(predictor)) {
+        return;
+    }
+
+    char* alpha_str = round_number(predictor->alpha);
+    char* error_str = round_number(predictor->error.mean);
+    char* abs_error_str = round_number(predictor->abs_error.mean);
+    char* relative_str = round_number(100 * predictor->relative_error.mean);
+    char* std_str = round_number(running_stat_stddev(&predictor->error));
+
+    fprintf(perf, "Prediction alpha = %s by %s: Mean error = %s Std error = %s Mean abs error = %s Mean abs %% error = %s%%\n",
+        alpha_str, predictor_key_name(predictor->key), error_str, std_str, abs_error_str, relative_str);
+    fflush(perf);
+
+    free(alpha_str);
+    free(error_str);
+    free(abs_error_str);
+    free(relative_str);
+    free(std_str);
+}
+
+/**
+ * @brief Write the average WTA of the same workload scheduled on the true runtimes
+ *
+ * @param[in] perf scheduler.perf file
+ * @param[in] oracle_wta average WTA of the oracle run
+ */
+void write_oracle_perf(FILE* perf, double oracle_wta) {
+    char* oracle_str = round_number(oracle_wta);
+    fprintf(perf, "Oracle Avg WTA = %s\n", oracle_str);
+    fflush(perf);
+    free(oracle_str);
+}
+
+/**
+ * @brief Write device utilization and CPU / I/O overlap, nothing when no process did I/O
+ *
+ * @param[in] perf scheduler.perf file
+ * @param[in] io I/O statistics of the run
+ * @param[in] devices device models of the run, indexed like io->device
+ * @param[in] device_count number of devices
+ * @param[in] total_time length of the run
+ */
+void write_io_perf(FILE* perf, const IoStats* io, const IoDevice* devices, int device_count, int total_time) {
+    if (io->requests == 0 || total_time <= 0) {
+        return;
+    }
+
+    char* busy_str = round_number(100.0 * io->io_busy_time / total_time);
+    char* overlap_str = round_number(100.0 * io->overlap_time / total_time);
+    fprintf(perf, "I/O requests = %lld I/O busy = %s%% CPU and I/O overlap = %s%%\n", io->requests, busy_str, overlap_str);
+    free(busy_str);
+    free(overlap_str);
+
+    for (int i = 0; i < device_count; i++) {
+        const IoDeviceStats* device = &io->device[i];
+        if (device->requests == 0) {
+            continue;
+        }
+        char* utilization_str = round_number(100.0 * device->busy_time / total_time);
+        char* service_str = round_number(device->service.mean);
+        char* wait_str = round_number(device->wait.mean);
+        fprintf(perf, "Device %s: utilization = %s%% requests = %lld Avg service = %s Avg queue wait = %s Max queue wait = %d\n",
+            devices[i].name, utilization_str, device->requests, service_str, wait_str, (int)device->wait.max);
+        free(utilization_str);
+        free(service_str);
+        free(wait_str);
+
+        // Disks: throughput, service time tail and head movement under the queue policy
+        if (devices[i].is_disk) {
+            char* throughput_str = round_number((double)device->requests / total_time);
+            char* p99_str = round_number(histogram_percentile(&device->service_hist, 99));
+            char* seek_str = round_number((double)device->seek_distance / device->requests);
+            fprintf(perf, "Disk %s (%s): reads = %lld writes = %lld Throughput = %s requests/tick Service p99 = %s Seek distance = %lld Avg seek distance = %s\n",
+                devices[i].name, disk_policy_name(devices[i].disk.policy), device->requests - device->writes, device->writes,
+                throughput_str, p99_str, device->seek_distance, seek_str);
+            free(throughput_str);
+            free(p99_str);
+            free(seek_str);
+        }
+    }
+    fflush(perf);
+}
+
+/**
+ * @brief Append the per CPU report to scheduler.perf (nothing on a single CPU)
+ * @details Speed-weighted utilization is the work done over the work all CPUs could have
+ *          done at their speeds, so an idle big core costs more than an idle little one.
+ *          A CPU's utilization counts the ticks it ran processes, overhead excluded.
+ */
+void write_cpu_perf(FILE* perf, const SimCpuStats* cpus, int cpu_count, int total_time, int migration_cost) {
+    if (cpu_count <= 1 || total_time <= 0) {
+        return;
+    }
+
+    long long work = 0;
+    long long migrations = 0;
+    double capacity = 0;
+    for (int i = 0; i < cpu_count; i++) {
+        work += cpus[i].work;
+        migrations += cpus[i].migrations;
+        capacity += cpus[i].speed * total_time;
+    }
+    char* weighted_str = round_number(100.0 * work / capacity);
+    fprintf(perf, "CPUs = %d Speed-weighted utilization = %s%% Migrations = %lld Migration cost = %lld\n",
+        cpu_count, weighted_str, migrations, migrations * migration_cost);
+    free(weighted_str);
+
+    for (int i = 0; i < cpu_count; i++) {
+        char* speed_str = round_number(cpus[i].speed);
+        char* utilization_str = round_number(100.0 * cpus[i].busy_time / total_time);
+        fprintf(perf, "CPU %d: speed = %s utilization = %s%% work = %lld migrations in = %lld\n",
+            i, speed_str, utilization_str, cpus[i].work, cpus[i].migrations);
+        free(speed_str);
+        free(utilization_str);
+    }
+    fflush(perf);
+}
+
+/**
+ * @brief Append the NUMA report to scheduler.perf (nothing on a single node)
+ * @details Local and remote time are the ticks processes ran on a CPU of the node holding
+ *          their memory or of another node. Per node, used memory and external fragmentation
+ *          are averaged over the run; internal fragmentation is the part of the allocated
+ *          bytes that blocks hold beyond their requests.
+ */
+void write_numa_perf(FILE* perf, const SimNodeStats* nodes, int node_count, const SimNuma* numa, int total_time) {
+    if (node_count <= 1 || total_time <= 0) {
+        return;
+    }
+
+    long long local = 0;
+    long long remote = 0;
+    long long fallbacks = 0;
+    for (int i = 0; i < node_count; i++) {
+        local += nodes[i].local_time;
+        remote += nodes[i].remote_time;
+        fallbacks += nodes[i].fallbacks;
+    }
+    char* penalty_str = round_number(numa->remote_penalty);
+    char* local_str = round_number(local + remote > 0 ? 100.0 * local / (local + remote) : 0);
+    fprintf(perf, "NUMA nodes = %d policy = %s remote penalty = %s Local run time = %s%% Fallback allocations = %lld\n",
+        node_count, numa_policy_name(numa->policy), penalty_str, local_str, fallbacks);
+    free(penalty_str);
+    free(local_str);
+
+    for (int i = 0; i < node_count; i++) {
+        const SimNodeStats* node = &nodes[i];
+        long long ran = node->local_time + node->remote_time;
+        char* node_local_str = round_number(ran > 0 ? 100.0 * node->local_time / ran : 0);
+        char* used_str = round_number(100.0 * node->used_area / ((double)node->memory_size * total_time));
+        char* internal_str = round_number(node->used_area > 0 ? 100.0 * node->internal_area / node->used_area : 0);
+        char* external_str = round_number(100.0 * node->external_area / total_time);
+        fprintf(perf, "Node %d: CPUs = %d memory = %d allocations = %lld fallbacks = %lld local run time = %s%% "
+            "Avg used = %s%% internal fragmentation = %s%% external fragmentation = %s%%\n",
+            i, node->cpu_count, node->memory_size, node->allocations, node->fallbacks, node_local_str,
+            used_str, internal_str, external_str);
+        free(node_local_str);
+        free(used_str);
+        free(internal_str);
+        free(external_str);
+    }
+    fflush(perf);
+}
+
+/**
+ * @brief Append the swapping report to scheduler.perf (nothing without a swap device)
+ * @details Time out of memory runs from the start of a swap-out to the end of the swap-in.
+ *          TA is split between the finished processes swapped out at least once and the others.
+ */
+void write_swap_perf(FILE* perf, const SimSwapStats* swap, const SimSwap* model, int total_time) {
+    if (model->bandwidth <= 0 || total_time <= 0) {
+        return;
+    }
+
+    char* utilization_str = round_number(100.0 * swap->busy_time / total_time);
+    fprintf(perf, "Swap bandwidth = %d latency = %d Swap outs = %lld Swap ins = %lld Bytes out = %lld Bytes in = %lld "
+        "Swap device utilization = %s%%\n", model->bandwidth, model->latency, swap->swap_outs, swap->swap_ins,
+        swap->bytes_out, swap->bytes_in, utilization_str);
+    free(utilization_str);
+
+    char* out_str = round_number(swap->out_time.mean);
+    char* swapped_ta_str = round_number(swap->ta_swapped.mean);
+    char* resident_ta_str = round_number(swap->ta_resident.mean);
+    fprintf(perf, "Swapped processes = %lld Avg TA = %s Avg time out of memory = %s Resident processes = %lld Avg TA = %s\n",
+        swap->ta_swapped.count, swapped_ta_str, out_str, swap->ta_resident.count, resident_ta_str);
+    free(out_str);
+    free(swapped_ta_str);
+    free(resident_ta_str);
+    fflush(perf);
+}
+
+/**
+ * @brief Append the memory admission report to scheduler.perf (nothing when no process waited for memory)
+ * @details Utilization is the part of the memory in allocated blocks, averaged over the run
+ *          and over each of its (at most TIMELINE_BUCKETS) stretches of time. The wait for
+ *          memory is per size class, from arrival to getting memory.
+ */
+void write_memory_perf(FILE* perf, const MemoryStats* memory, const AdmitConfig* admit, int capacity, int end_time) {
+    if (memory->waited == 0 || capacity <= 0 || end_time <= 0) {
+        return;
+    }
+
+    int buckets = timeline_buckets(&memory->used, end_time);
+    double used = 0;
+    for (int i = 0; i < buckets; i++) {
+        used += memory->used.area[i];
+    }
+    char* used_str = round_number(100.0 * used / ((double)capacity * end_time));
+    char* peak_str = round_number(100.0 * memory->used.max / capacity);
+    fprintf(perf, "Memory admission = %s", admit_policy_name(admit->policy));
+    if (admit->policy == ADMIT_AGING) {
+        fprintf(perf, " (age %d)", admit->age);
+    }
+    fprintf(perf, " Avg utilization = %s%% Peak utilization = %s%% Waited for memory = %lld\n",
+        used_str, peak_str, memory->waited);
+    free(used_str);
+    free(peak_str);
+
+    fprintf(perf, "Memory utilization over time (%d ticks each) =", memory->used.width);
+    for (int i = 0; i < buckets; i++) {
+        char* bucket_str = round_number(100.0 * timeline_mean(&memory->used, i, end_time) / capacity);
+        fprintf(perf, " %s%%", bucket_str);
+        free(bucket_str);
+    }
+    fprintf(perf, "\n");
+
+    char label[32];
+    for (int i = 0; i < JOB_SIZE_CLASSES; i++) {
+        const RunningStat* wait = &memory->wait[i];
+        if (wait->count == 0) {
+            continue;
+        }
+        if (i == JOB_SIZE_CLASSES - 1) {
+            snprintf(label, sizeof(label), "Size %d+", 1 << i);
+        }
+        else {
+            snprintf(label, sizeof(label), "Size %d-%d", 1 << i, (2 << i) - 1);
+        }
+        char* avg_str = round_number(wait->mean);
+        fprintf(perf, "Memory wait %s: count = %lld Avg = %s Max = %d\n", label, wait->count, avg_str, (int)wait->max);
+        free(avg_str);
+    }
+    fflush(perf);
+}
+
+/**
+ * @brief Append the task group fair share report to scheduler.perf (nothing without groups)
+ * @details CPU share is the group's part of the CPU time all processes ran, entitled is
+ *          its part of the shares of the groups that had processes.
+ */
+void write_group_perf(FILE* perf, const TaskGroup* models, const TaskGroupStats* groups, int group_count,
+    int busy_time, int total_time) {
+    if (!task_groups_enabled(models, group_count) || busy_time <= 0 || total_time <= 0) {
+        return;
+    }
+
+    // Groups without processes (e.g. the default group) are left out
+    long long total_shares = 0;
+    for (int i = 0; i < group_count; i++) {
+        if (groups[i].cpu_time > 0 || groups[i].ta.count > 0) {
+            total_shares += models[i].shares;
+        }
+    }
+
+    for (int i = 0; i < group_count; i++) {
+        const TaskGroup* model = &models[i];
+        const TaskGroupStats* group = &groups[i];
+        if (group->cpu_time == 0 && group->ta.count == 0) {
+            continue;
+        }
+
+        char* share_str = round_number(100.0 * group->cpu_time / busy_time);
+        char* entitled_str = round_number(100.0 * model->shares / total_shares);
+        char* throttled_str = round_number(100.0 * group->throttled_time / total_time);
+        fprintf(perf, "Group %s: shares = %d", model->name, model->shares);
+        if (model->quota > 0) {
+            fprintf(perf, " quota = %d/%d", model->quota, model->period);
+        }
+        fprintf(perf, " CPU share = %s%% entitled = %s%% throttled = %d (%s%%, %lld periods) finished = %lld",
+            share_str, entitled_str, group->throttled_time, throttled_str, group->throttled_periods, group->ta.count);
+        free(share_str);
+        free(entitled_str);
+        free(throttled_str);
+
+        if (group->ta.count == 0) {
+            fprintf(perf, "\n");
+            continue;
+        }
+        char* wait_str = round_number(group->wait.mean);
+        fprintf(perf, " Avg Waiting = %s\n", wait_str);
+        free(wait_str);
+
+        char name[TASK_GROUP_NAME_SIZE + 16];
+        snprintf(name, sizeof(name), "Group %s TA", model->name);
+        perf_percentiles_out(perf, name, &group->ta_hist);
+        snprintf(name, sizeof(name), "Group %s Response", model->name);
+        perf_percentiles_out(perf, name, &group->response_hist);
+    }
+    fflush(perf);
+}
+
+/**
+ * @brief Append the oracle run's average WTA to scheduler.perf
+ */
+void oracle_perf_out(double oracle_wta) {
+    FILE* perf = fopen("scheduler.perf", "a");
+    if (perf == NULL) {
+        perror("Failed to open scheduler perf file");
+        return;
+    }
+    write_oracle_perf(perf, oracle_wta);
+    fclose(perf);
+}
+
+/**
+ * @brief Append the generator's memory admission report to scheduler.perf
+ */
+void memory_perf_out(const MemoryStats* memory, const AdmitConfig* admit, int capacity, int end_time) {
+    if (memory->waited == 0) {
+        return;
+    }
+    FILE* perf = fopen("scheduler.perf", "a");
+    if (perf == NULL) {
+        perror("Failed to open scheduler perf file");
+        return;
+    }
+    write_memory_perf(perf, memory, admit, capacity, end_time);
+    fclose(perf);
 }
 
 /**
@@ -249,8 +1028,8 @@ void scheduler_perf_out(int total_idle, int total_time) {
  */
 char* round_number(double number) {
     // Format WTA to 2 decimal places and trim trailing zeros
-    char* str = malloc(32);                     // Allocate memory
-    snprintf(str, sizeof(str), "%.2f", number); // Round and format to string
+    char* str = malloc(32);          // Allocate memory
+    snprintf(str, 32, "%.2f", number); // Round and format to string
     int len = strlen(str);
     while (len > 0 && str[len - 1] == '0') {
         str[--len] = '\0'; // Remove trailing zero
@@ -1,18 +1,46 @@
 #ifndef FILE_HANDLERS_H
 #define FILE_HANDLERS_H
 
+#include <stdio.h>
 #include "process.h"
 #include "PCB.h"
+#include "stats.h"
+#include "periodic.h"
+#include "predictor.h"
+#include "io_device.h"
+#include "task_group.h"
+#include "sim_engine.h"
 
 int read_input_file(const char *filename, Process **process_list, int *process_count);
+void free_process_list(Process* process_list, int process_count);
 // exit code 0 for success, 1 for error
+int read_task_file(const char* filename, PeriodicTask** tasks, int* task_count);
 
 void init_scheduler_log();
 void log_event(PCB *pcb);
-void scheduler_perf_out(int total_idle, int total_time);
+void record_admission(int rejected);
+void scheduler_perf_out(int total_idle, int total_time, const Predictor* predictor);
+void write_scheduler_log_header(FILE* log);
+void write_event(FILE* log, PCB* pcb, int current_time);
+void write_perf(FILE* perf, const PerfStats* stats, const JobTable* jobs, int total_idle, int total_overhead, int total_time);
+void rolling_report_out(int current_time, int interval, int queue_depth);
+void dispatch_perf_out(const RunningStat* lag, const Histogram* lag_hist);
+void write_prediction_perf(FILE* perf, const Predictor* predictor);
+void write_oracle_perf(FILE* perf, double oracle_wta);
+void write_io_perf(FILE* perf, const IoStats* io, const IoDevice* devices, int device_count, int total_time);
+void write_cpu_perf(FILE* perf, const SimCpuStats* cpus, int cpu_count, int total_time, int migration_cost);
+void write_numa_perf(FILE* perf, const SimNodeStats* nodes, int node_count, const SimNuma* numa, int total_time);
+void write_swap_perf(FILE* perf, const SimSwapStats* swap, const SimSwap* model, int total_time);
+void write_memory_perf(FILE* perf, const MemoryStats* memory, const AdmitConfig* admit, int capacity, int end_time);
+void write_group_perf(FILE* perf, const TaskGroup* models, const TaskGroupStats* groups, int group_count,
+    int busy_time, int total_time);
+void oracle_perf_out(double oracle_wta);
+void memory_perf_out(const MemoryStats* memory, const AdmitConfig* admit, int capacity, int end_time);
 char *round_number(double number);
 
 void init_memory_log();
 void log_memory_event(int pid, Block* block, int type);
+void write_memory_log_header(FILE* log);
+void write_memory_event(FILE* log, int pid, Block* block, int type, int current_time);
 
 #endif
\ No newline at end of file
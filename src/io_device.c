@@ -0,0 +1,220 @@
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "io_device.h"
+
+IoDevice io_devices[IO_MAX_DEVICES];
+int io_device_count = 0;
+
+/**
+ * @brief Index of the device called `name`, registering it when it is new
+ *
+ * @return int the device index, -1 for an invalid name or a full device table
+ */
+int io_device_id(const char* name) {
+    size_t length = strlen(name);
+    if (length == 0 || length >= IO_DEVICE_NAME_SIZE) {
+        return -1;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (!isalnum((unsigned char)name[i]) && name[i] != '_') {
+            return -1;
+        }
+    }
+
+    for (int i = 0; i < io_device_count; i++) {
+        if (strcmp(io_devices[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (io_device_count == IO_MAX_DEVICES) {
+        return -1;
+    }
+
+    IoDevice* device = &io_devices[io_device_count];
+    memset(device, 0, sizeof(IoDevice));
+    strcpy(device->name, name);
+    return io_device_count++;
+}
+
+/**
+ * @brief Device named by the "<name>=" prefix of `spec`, registering it when it is new
+ *
+ * @param[out] model what follows the '='
+ *
+ * @return int the device index, -1 for an invalid spec
+ */
+static int io_device_spec(const char* spec, const char** model) {
+    *model = strchr(spec, '=');
+    if (*model == NULL || *model - spec >= IO_DEVICE_NAME_SIZE) {
+        return -1;
+    }
+
+    char name[IO_DEVICE_NAME_SIZE];
+    memcpy(name, spec, *model - spec);
+    name[*model - spec] = '\0';
+    (*model)++;
+    return io_device_id(name);
+}
+
+/**
+ * @brief Parse "<name>=<distribution>", the service time model of a device
+ *
+ * @return int 0 for success, 1 for an invalid name or distribution, or a disk
+ */
+int parse_io_device(const char* spec) {
+    const char* model;
+    int id = io_device_spec(spec, &model);
+    if (id < 0 || io_devices[id].is_disk) {
+        return 1;
+    }
+
+    Distribution service;
+    if (dist_parse(&service, model) != 0) {
+        return 1;
+    }
+    if (io_devices[id].has_model) {
+        dist_free(&io_devices[id].service);
+    }
+    io_devices[id].service = service;
+    io_devices[id].has_model = 1;
+    return 0;
+}
+
+/**
+ * @brief Parse "<name>=<policy>[,<option>=<value>...]", make the device a disk (see parse_disk_model)
+ *
+ * @return int 0 for success, 1 for an invalid name or disk model, or a device with a service time model
+ */
+int parse_io_disk(const char* spec) {
+    const char* model;
+    int id = io_device_spec(spec, &model);
+    if (id < 0 || io_devices[id].has_model || parse_disk_model(model, &io_devices[id].disk) != 0) {
+        return 1;
+    }
+    io_devices[id].is_disk = 1;
+    return 0;
+}
+
+/**
+ * @brief Parse an alternating CPU / I/O burst list such as "4,disk:3,2,net,1"
+ * @details The list starts and ends with a CPU burst and the CPU bursts add up to `runtime`.
+ *          An I/O burst without ticks needs a device with a service time model, a disk
+ *          request names a cylinder of the disk ("disk@120", or "disk@120w" for a write).
+ *
+ * @param[out] bursts the I/O bursts (heap allocated, NULL when there are none)
+ * @param[out] count number of I/O bursts
+ *
+ * @return int 0 for success, 1 for an invalid list
+ */
+int parse_io_bursts(const char* spec, int runtime, IoBurst** bursts, int* count) {
+    *bursts = NULL;
+    *count = 0;
+
+    char* copy = strdup(spec);
+    if (copy == NULL) {
+        return 1;
+    }
+
+    int capacity = 0;
+    int cpu = 0;       // CPU ticks before the current burst
+    int expect_cpu = 1;
+    int status = 0;
+    char* save = NULL;
+    for (char* item = strtok_r(copy, ",", &save); item != NULL; item = strtok_r(NULL, ",", &save)) {
+        char* end;
+        if (expect_cpu) {
+            long ticks = strtol(item, &end, 10);
+            if (*item == '\0' || *end != '\0' || ticks <= 0 || ticks > runtime - cpu) {
+                status = 1;
+                break;
+            }
+            cpu += (int)ticks;
+            expect_cpu = 0;
+            continue;
+        }
+
+        IoBurst burst = { cpu, 0, 0, -1, 0 };
+        char* cylinder = strchr(item, '@');
+        if (cylinder != NULL) {
+            *cylinder++ = '\0';
+            long position = strtol(cylinder, &end, 10);
+            burst.write = *end == 'w';
+            if (*cylinder == '\0' || position < 0 || position > INT_MAX ||
+                !(*end == '\0' || ((*end == 'w' || *end == 'r') && end[1] == '\0'))) {
+                status = 1;
+                break;
+            }
+            burst.cylinder = (int)position;
+        }
+        char* ticks = strchr(item, ':');
+        if (ticks != NULL) {
+            *ticks++ = '\0';
+            long service = strtol(ticks, &end, 10);
+            if (*ticks == '\0' || *end != '\0' || service <= 0 || service > WORKLOAD_MAX_RUNTIME) {
+                status = 1;
+                break;
+            }
+            burst.service = (int)service;
+        }
+        burst.device = io_device_id(item);
+        if (burst.device < 0) {
+            status = 1;
+            break;
+        }
+        const IoDevice* device = &io_devices[burst.device];
+        if (device->is_disk ? (burst.cylinder < 0 || burst.cylinder >= device->disk.cylinders || burst.service > 0) :
+            (burst.cylinder >= 0 || (burst.service == 0 && !device->has_model))) {
+            status = 1;
+            break;
+        }
+
+        if (*count == capacity) {
+            capacity = capacity == 0 ? 4 : capacity * 2;
+            IoBurst* grown = realloc(*bursts, capacity * sizeof(IoBurst));
+            if (grown == NULL) {
+                status = 1;
+                break;
+            }
+            *bursts = grown;
+        }
+        (*bursts)[(*count)++] = burst;
+        expect_cpu = 1;
+    }
+    free(copy);
+
+    if (status != 0 || expect_cpu || cpu != runtime) {
+        free(*bursts);
+        *bursts = NULL;
+        *count = 0;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Service ticks of a request to `device` (at least one)
+ */
+int io_service_time(const IoDevice* device, const IoBurst* burst, Rng* rng) {
+    if (burst->service > 0) {
+        return burst->service;
+    }
+    double ticks = round(dist_sample(&device->service, rng));
+    if (ticks < 1) {
+        return 1;
+    }
+    return ticks > WORKLOAD_MAX_RUNTIME ? WORKLOAD_MAX_RUNTIME : (int)ticks;
+}
+
+void io_stats_init(IoStats* stats) {
+    memset(stats, 0, sizeof(IoStats));
+    for (int i = 0; i < IO_MAX_DEVICES; i++) {
+        running_stat_init(&stats->device[i].wait);
+        running_stat_init(&stats->device[i].service);
+        histogram_init(&stats->device[i].service_hist, 1);
+    }
+}
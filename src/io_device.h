@@ -0,0 +1,66 @@
+#ifndef IO_DEVICE_H
+#define IO_DEVICE_H
+
+#include "process.h"
+#include "stats.h"
+#include "workload.h"
+#include "disk.h"
+
+/**
+ * I/O bursts and simulated devices.
+ * A process alternates CPU and I/O bursts, written "4,disk:3,2,net,1" in the input file:
+ * 4 ticks of CPU, 3 ticks on disk, 2 ticks of CPU, one request to net whose service time
+ * is drawn from the device's model, 1 tick of CPU. Devices are registered by name the
+ * first time they are seen and serve one request at a time in FIFO order. Requests to a
+ * disk name a cylinder instead ("disk@120", "disk@120w" for a write) and the disk's
+ * queue policy orders them (see disk.h).
+ */
+
+#define IO_MAX_DEVICES 8
+#define IO_DEVICE_NAME_SIZE 16
+
+typedef struct IoBurst {
+    int after;    // CPU ticks the process has run when it issues the request
+    int device;   // index in the device table
+    int service;  // service ticks, 0 draws them from the device's service model
+    int cylinder; // disk requests, -1 for other devices
+    int write;    // disk requests: 1 for a write, 0 for a read
+} IoBurst;
+
+typedef struct IoDevice {
+    char name[IO_DEVICE_NAME_SIZE];
+    Distribution service; // service time model (-I <name>=<distribution>)
+    int has_model;
+    int is_disk;    // requests are served by the disk model (-K <name>=<policy>)
+    DiskModel disk;
+} IoDevice;
+
+typedef struct IoDeviceStats {
+    long long requests;
+    int busy_time;
+    RunningStat wait;    // ticks a request queued behind others
+    RunningStat service; // ticks a request was served
+    Histogram service_hist;
+    long long writes;        // disk write requests
+    long long seek_distance; // disk cylinders crossed
+} IoDeviceStats;
+
+typedef struct IoStats {
+    IoDeviceStats device[IO_MAX_DEVICES];
+    long long requests;
+    int io_busy_time; // time at least one device was busy
+    int overlap_time; // time the CPU and at least one device were busy together
+} IoStats;
+
+// Device table the input parser registers devices in, handed to the simulation in its SimConfig
+extern IoDevice io_devices[IO_MAX_DEVICES];
+extern int io_device_count;
+
+int io_device_id(const char* name);
+int parse_io_device(const char* spec);
+int parse_io_disk(const char* spec);
+int parse_io_bursts(const char* spec, int runtime, IoBurst** bursts, int* count);
+int io_service_time(const IoDevice* device, const IoBurst* burst, Rng* rng);
+void io_stats_init(IoStats* stats);
+
+#endif /* IO_DEVICE_H */
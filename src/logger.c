@@ -0,0 +1,34 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "logger.h"
+
+int log_level = LOG_LEVEL_INFO; // Runtime level, inherited by forked children
+
+/**
+ * @brief Parse a level name (off, error, info, debug, trace)
+ *
+ * @return int 0 for success, 1 for unknown name
+ */
+int parse_log_level(const char* name, int* level) {
+    static const char* names[] = { "off", "error", "info", "debug", "trace" };
+
+    for (int i = LOG_LEVEL_OFF; i <= LOG_LEVEL_TRACE; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *level = i;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Write one message; call through the LOG_* macros so filtered messages cost nothing
+ */
+void log_write(int level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(level == LOG_LEVEL_ERROR ? stderr : stdout, format, args);
+    va_end(args);
+}
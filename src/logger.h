@@ -0,0 +1,38 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+/**
+ * Leveled logging.
+ * Messages above the runtime level (log_level, set with -l) are skipped before any formatting,
+ * and messages above LOG_COMPILE_LEVEL (make LOG_COMPILE_LEVEL=INFO) are not compiled at all.
+ * Errors go to stderr, everything else to stdout.
+ */
+
+#define LOG_LEVEL_OFF   0
+#define LOG_LEVEL_ERROR 1 // failures
+#define LOG_LEVEL_INFO  2 // start-up and end of run messages
+#define LOG_LEVEL_DEBUG 3 // one message per process lifecycle event
+#define LOG_LEVEL_TRACE 4 // per tick, per queue and per allocator operation
+
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_TRACE
+#endif
+
+extern int log_level;
+
+int parse_log_level(const char* name, int* level);
+void log_write(int level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+#define LOG_AT(level, ...)                                                 \
+    do {                                                                   \
+        if ((level) <= LOG_COMPILE_LEVEL && (level) <= log_level) {        \
+            log_write((level), __VA_ARGS__);                               \
+        }                                                                  \
+    } while (0)
+
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_INFO(...)  LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_TRACE(...) LOG_AT(LOG_LEVEL_TRACE, __VA_ARGS__)
+
+#endif /* LOGGER_H */
@@ -1,27 +1,37 @@
 #include "memory_manager.h"
+#include "logger.h"
+#include "clk.h"
 
 // Define a global waiting list for PCBs
 Block *memory = NULL;
-
-HashMap *memory_map = NULL; // HashMap to store memory blocks
+MemoryStats memory_stats;
+static int memory_used = 0; // bytes in allocated blocks
 
 void init_memory_manager()
 {
     memory = init_memory();
+    memory_stats_init(&memory_stats);
     init_memory_log();
-    memory_map = hashmap_create(100);
 }
 
-int deallocate_process_memory(int pid)
+static void account_memory(const Block *block, int sign)
 {
-    ProcessMemory *pmem = hashmap_get(memory_map, pid);
-    if (pmem == NULL || pmem->memory == NULL)
+    memory_used += sign * block->size;
+    timeline_set(&memory_stats.used, get_clk(), memory_used);
+}
+
+int deallocate_process_memory(int slot)
+{
+    PCB *pcb = pcb_at(slot);
+    if (pcb->memory_block == NULL)
     {
-        printf("Error: No memory block found for process %d\n", pid);
+        LOG_ERROR("Error: No memory block found for process %d\n", pcb->pid);
         return 0;
     }
-    log_memory_event(pmem->id, pmem->memory, 0); // Log deallocation event
-    deallocate_memory(pmem->memory);
+    log_memory_event(pcb->PDATA.id, pcb->memory_block, 0); // Log deallocation event
+    account_memory(pcb->memory_block, -1);
+    deallocate_memory(pcb->memory_block);
+    pcb->memory_block = NULL;
     // print_memo(memory);
     return 1; // Deallocation successful
 }
@@ -29,29 +39,30 @@ int deallocate_process_memory(int pid)
 Block *allocate_process_memory(int size)
 {
     Block *allocated = allocate_memory(memory, size);
+    if (allocated != NULL)
+    {
+        account_memory(allocated, 1);
+    }
     return allocated; // either null no space or return the address of the allocated memory set it at generator
 }
 
+// Give back a block no process got (e.g. the PCB table was full)
+void return_process_memory(Block *block)
+{
+    account_memory(block, -1);
+    deallocate_memory(block);
+}
+
 void assign_memory_block_to_process(PCB *process, Block *block)
 {
     if (block == NULL)
     {
-        printf("Error: No memory block available for process %d\n", process->PDATA.id);
-        return;
-    }
-    ProcessMemory *process_memory = malloc(sizeof(ProcessMemory));
-    process_memory->memory = block;
-    process_memory->id = process->PDATA.id;
-    if (hashmap_put(memory_map, process->pid, process_memory) > 0)
-    {
-        process->memory_block = block;
-        log_memory_event(process_memory->id, block, 1); // Log allocation event
-    }
-    else
-    {
-        printf("Error: Failed to assign memory block to process %d\n", process->pid);
+        LOG_ERROR("Error: No memory block available for process %d\n", process->PDATA.id);
         return;
     }
+    process->memory_block = block;
+    log_memory_event(process->PDATA.id, block, 1); // Log allocation event
+    memory_stats_admit(&memory_stats, process->PDATA.memory_size, process->PDATA.arrival_time, get_clk());
 }
 
 // void add_to_waiting_list(PCB* process)
@@ -60,30 +71,17 @@ void assign_memory_block_to_process(PCB *process, Block *block)
 //     add_node_to_back(waiting_list, node);
 // }
 
-// TODO GET THE BLOCK TOO
-Process *get_oldest_fit(LinkedList *waiting_list) // search for the oldest process that can fit and return it after removing it from wiaitng list
+Process *get_admissible(OrderQueue *waiting, const AdmitConfig *admit, int *held) // pick the waiting process the admission policy admits next and remove it from the waiting queue
 {
-    if (waiting_list->size == 0)
+    int order = admit_pick(admit, waiting->first, waiting->orders, free_orders(memory), block_order(MAX_SIZE), get_clk(), held);
+    if (order < 0)
     {
         return NULL;
     }
 
-
-    Node *current = waiting_list->head;
-    while (current != NULL)
-    {
-        Process *process = (Process *)current->data;
-        Block *fit_block = get_smallest_block_available(memory, process->memory_size);
-        if (fit_block != NULL)
-        {
-            printf("Debug: Found fitting process %d with memory size %d, start %d, allc %d\n", process->id, fit_block->size, fit_block->start, fit_block->allocated);
-            remove_node(waiting_list, current);
-            return process; // Found a process that fits
-        }
-        current = current->next;
-    }
-
-    return NULL; // No fitting process found
+    Process *process = (Process *)oq_pop(waiting, order);
+    LOG_TRACE("Debug: Found fitting process %d with memory size %d\n", process->id, process->memory_size);
+    return process;
 }
 
 Block* get_smallest_block(Process* process)
@@ -91,7 +89,7 @@ Block* get_smallest_block(Process* process)
     Block* block = get_smallest_block_available(memory, process->memory_size);
     if (block == NULL)
     {
-        printf("Error: No memory block available for process %d\n", process->id);
+        LOG_ERROR("Error: No memory block available for process %d\n", process->id);
         return NULL;
     }
     return block;
@@ -100,5 +98,4 @@ Block* get_smallest_block(Process* process)
 void free_memory_manager()
 {
     destroy_memory(memory);
-    hashmap_free(memory_map);
 }
\ No newline at end of file
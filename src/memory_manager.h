@@ -1,21 +1,26 @@
+#ifndef MEMORY_MANAGER_H
+#define MEMORY_MANAGER_H
+
 #include "PCB.h"
 #include <stddef.h>
 #include "buddy_memory.h"
-#include "DS/linked_list.h"
-#include "DS/hash_map.h"
+#include "DS/order_queue.h"
+#include "admission.h"
+#include "stats.h"
+#include "pcb_table.h"
 #include "file_handlers.h"
 #include <stdio.h>
 
-typedef struct {
-    Block *memory;
-    int id; // process id
-} ProcessMemory;
+extern MemoryStats memory_stats; // memory in use over time and the wait for memory
 
 void init_memory_manager();
 void free_memory_manager();
 Block *allocate_process_memory (int size);
-int deallocate_process_memory (int pid);
-Process* get_oldest_fit(LinkedList * waiting_list);
+int deallocate_process_memory (int slot);
+void return_process_memory(Block* block);
+Process* get_admissible(OrderQueue* waiting, const AdmitConfig* admit, int* held);
 Block* get_smallest_block(Process* process);
 void assign_memory_block_to_process(PCB* process, Block* block);
-// search for the oldest process that can fit and return it after removing it from wiaitng list
+// pick the waiting process the admission policy admits next and remove it from the waiting queue
+
+#endif // MEMORY_MANAGER_H
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/shm.h>
+
+#include "pcb_table.h"
+
+PCBTable* pcb_table = NULL;
+
+static int next_slot = 0; // Generator only: where the search for a free slot resumes
+
+/**
+ * @brief Create the run's PCB table in private shared memory
+ * @details Call once in the process generator before forking, like create_clk();
+ *          the scheduler inherits the mapping. The segment goes away with the last process of the run.
+ */
+void create_pcb_table() {
+    int shmid = shmget(IPC_PRIVATE, sizeof(PCBTable), IPC_CREAT | 0600);
+    if (shmid == -1) {
+        perror("Error in creating the PCB table shm!");
+        exit(EXIT_FAILURE);
+    }
+
+    pcb_table = (PCBTable*)shmat(shmid, NULL, 0);
+    if ((long)pcb_table == -1) {
+        perror("Error in attaching the PCB table shm!");
+        exit(EXIT_FAILURE);
+    }
+    shmctl(shmid, IPC_RMID, NULL);
+}
+
+/**
+ * @brief Take a free slot for a new process (generator only)
+ *
+ * @return int the slot, owned by both the process and the scheduler, -1 if the table is full
+ */
+int pcb_table_acquire() {
+    for (int i = 0; i < PCB_TABLE_CAPACITY; i++) {
+        int slot = (next_slot + i) % PCB_TABLE_CAPACITY;
+        if (__atomic_load_n(&pcb_table->owners[slot], __ATOMIC_ACQUIRE) == 0) {
+            __atomic_store_n(&pcb_table->owners[slot], PCB_SLOT_PROCESS | PCB_SLOT_SCHEDULER, __ATOMIC_RELAXED);
+            next_slot = (slot + 1) % PCB_TABLE_CAPACITY;
+            return slot;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Drop one owner of a slot, the slot is free once both owners dropped it
+ */
+void pcb_table_release(int slot, int owner) {
+    __atomic_fetch_and(&pcb_table->owners[slot], ~owner, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Slot of the live process with the given pid (generator only)
+ *
+ * @return int the slot, -1 if not found
+ */
+int pcb_table_find_pid(int pid) {
+    for (int slot = 0; slot < PCB_TABLE_CAPACITY; slot++) {
+        if ((__atomic_load_n(&pcb_table->owners[slot], __ATOMIC_ACQUIRE) & PCB_SLOT_PROCESS) && pcb_table->slots[slot].pid == pid) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+PCB* pcb_at(int slot) {
+    return &pcb_table->slots[slot];
+}
+
+int pcb_slot(const PCB* pcb) {
+    return (int)(pcb - pcb_table->slots);
+}
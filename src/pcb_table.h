@@ -0,0 +1,36 @@
+#ifndef PCB_TABLE_H
+#define PCB_TABLE_H
+
+#include "PCB.h"
+#include "buddy_memory.h"
+
+/**
+ * Shared-memory PCB table of a run.
+ * The process generator creates it before forking, fills a slot for every admitted process
+ * and sends only the slot index to the scheduler, which works on the PCB in place.
+ *
+ * A slot is owned by the process (until the generator reaps it) and by the scheduler
+ * (until the process finishes); it is reused once both have released it.
+ */
+
+// Every admitted process holds a distinct buddy block of at least 1 byte
+#define PCB_TABLE_CAPACITY MAX_SIZE
+
+#define PCB_SLOT_PROCESS   1 // released by the generator when the process exits
+#define PCB_SLOT_SCHEDULER 2 // released by the scheduler when the process finishes
+
+typedef struct PCBTable {
+    int owners[PCB_TABLE_CAPACITY]; // PCB_SLOT_* bits, 0 when the slot is free
+    PCB slots[PCB_TABLE_CAPACITY];
+} PCBTable;
+
+extern PCBTable* pcb_table;
+
+void create_pcb_table();
+int pcb_table_acquire();
+void pcb_table_release(int slot, int owner);
+int pcb_table_find_pid(int pid);
+PCB* pcb_at(int slot);
+int pcb_slot(const PCB* pcb);
+
+#endif /* PCB_TABLE_H */
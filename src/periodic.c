@@ -0,0 +1,94 @@
+#include <math.h>
+
+#include "periodic.h"
+
+/**
+ * @brief Rate-monotonic order: whether task a has a higher priority than task b
+ * @details Shorter period first, ties broken by id so the order is total.
+ */
+int periodic_before(const PeriodicTask* a, const PeriodicTask* b) {
+    return a->period < b->period || (a->period == b->period && a->id < b->id);
+}
+
+/**
+ * @brief Total utilization: sum of wcet / period
+ */
+double periodic_utilization(const PeriodicTask* tasks, int count) {
+    double utilization = 0;
+    for (int i = 0; i < count; i++) {
+        utilization += (double)tasks[i].wcet / tasks[i].period;
+    }
+    return utilization;
+}
+
+/**
+ * @brief Total density: sum of wcet / deadline (equals the utilization for implicit deadlines)
+ */
+double periodic_density(const PeriodicTask* tasks, int count) {
+    double density = 0;
+    for (int i = 0; i < count; i++) {
+        density += (double)tasks[i].wcet / tasks[i].deadline;
+    }
+    return density;
+}
+
+/**
+ * @brief Liu-Layland utilization bound n (2^(1/n) - 1) of rate-monotonic scheduling
+ */
+double liu_layland_bound(int count) {
+    if (count <= 0) {
+        return 1;
+    }
+    return count * (pow(2.0, 1.0 / count) - 1);
+}
+
+/**
+ * @brief Worst-case response time of a task under preemptive rate-monotonic scheduling
+ * @details Iterates R = C_i + sum over higher-priority tasks j of ceil(R / T_j) C_j
+ *          from R = C_i until it converges or exceeds the deadline (constrained deadlines).
+ *
+ * @return int the response time, -1 if it exceeds the task's deadline
+ */
+int periodic_response_time(const PeriodicTask* tasks, int count, int index) {
+    const PeriodicTask* task = &tasks[index];
+    long long response = task->wcet;
+
+    while (response <= task->deadline) {
+        long long next = task->wcet;
+        for (int j = 0; j < count; j++) {
+            if (j != index && periodic_before(&tasks[j], task)) {
+                next += ((response + tasks[j].period - 1) / tasks[j].period) * tasks[j].wcet;
+            }
+        }
+        if (next == response) {
+            return (int)response;
+        }
+        response = next;
+    }
+    return -1;
+}
+
+static long long gcd(long long a, long long b) {
+    while (b != 0) {
+        long long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * @brief Least common multiple of the periods
+ *
+ * @return long long the hyperperiod, -1 if it exceeds `limit`
+ */
+long long periodic_hyperperiod(const PeriodicTask* tasks, int count, long long limit) {
+    long long hyperperiod = 1;
+    for (int i = 0; i < count; i++) {
+        hyperperiod = hyperperiod / gcd(hyperperiod, tasks[i].period) * tasks[i].period;
+        if (hyperperiod > limit) {
+            return -1;
+        }
+    }
+    return hyperperiod;
+}
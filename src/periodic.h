@@ -0,0 +1,26 @@
+#ifndef PERIODIC_H
+#define PERIODIC_H
+
+/**
+ * Periodic task model: task k releases a job of `wcet` ticks at phase + k * period,
+ * due `deadline` ticks after its release (0 < deadline <= period).
+ * Offline schedulability analysis for fixed-priority rate-monotonic and EDF scheduling.
+ */
+
+typedef struct PeriodicTask {
+    int id;
+    int phase;       // release time of the first job
+    int wcet;        // runtime of every job
+    int period;
+    int deadline;    // relative to the release
+    int memory_size; // memory of every job
+} PeriodicTask;
+
+int periodic_before(const PeriodicTask* a, const PeriodicTask* b);
+double periodic_utilization(const PeriodicTask* tasks, int count);
+double periodic_density(const PeriodicTask* tasks, int count);
+double liu_layland_bound(int count);
+int periodic_response_time(const PeriodicTask* tasks, int count, int index);
+long long periodic_hyperperiod(const PeriodicTask* tasks, int count, long long limit);
+
+#endif /* PERIODIC_H */
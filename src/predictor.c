@@ -0,0 +1,98 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "predictor.h"
+
+/**
+ * @brief Reset a predictor
+ *
+ * @param[in] alpha weight of the latest burst in (0, 1], 0 disables prediction
+ * @param[in] key what makes two processes the same class
+ */
+void predictor_init(Predictor* predictor, double alpha, PredictorKey key) {
+    memset(predictor, 0, sizeof(Predictor));
+    predictor->alpha = alpha;
+    predictor->key = key;
+    running_stat_init(&predictor->error);
+    running_stat_init(&predictor->abs_error);
+    running_stat_init(&predictor->relative_error);
+}
+
+/**
+ * @brief Parse "<alpha>[,priority|size]" (classes by priority by default)
+ *
+ * @return int 0 for success, 1 for an alpha outside (0, 1] or an unknown class key
+ */
+int parse_predictor(const char* spec, Predictor* predictor) {
+    char* end;
+    double alpha = strtod(spec, &end);
+    if (end == spec || alpha <= 0 || alpha > 1) {
+        return 1;
+    }
+
+    PredictorKey key = PREDICT_BY_PRIORITY;
+    if (*end == ',') {
+        if (strcmp(end + 1, "priority") == 0) {
+            key = PREDICT_BY_PRIORITY;
+        }
+        else if (strcmp(end + 1, "size") == 0) {
+            key = PREDICT_BY_SIZE;
+        }
+        else {
+            return 1;
+        }
+    }
+    else if (*end != '\0') {
+        return 1;
+    }
+
+    predictor_init(predictor, alpha, key);
+    return 0;
+}
+
+int predictor_enabled(const Predictor* predictor) {
+    return predictor->alpha > 0;
+}
+
+const char* predictor_key_name(PredictorKey key) {
+    return key == PREDICT_BY_SIZE ? "size" : "priority";
+}
+
+static int predictor_class(const Predictor* predictor, const Process* proc) {
+    if (predictor->key == PREDICT_BY_SIZE) {
+        return job_size_class(proc->memory_size);
+    }
+    int priority_class = proc->priority < 0 ? 0 : proc->priority;
+    return priority_class < PREDICTOR_CLASSES ? priority_class : PREDICTOR_CLASSES - 1;
+}
+
+/**
+ * @brief Predicted burst of a process, in whole ticks (at least one)
+ */
+int predictor_estimate(const Predictor* predictor, const Process* proc) {
+    int c = predictor_class(predictor, proc);
+    double estimate = predictor->seen[c] ? predictor->estimate[c] :
+        predictor->overall_seen ? predictor->overall : PREDICTOR_DEFAULT_BURST;
+    int ticks = (int)lround(estimate);
+    return ticks > 0 ? ticks : 1;
+}
+
+static void predictor_average(double* estimate, int* seen, double alpha, double burst) {
+    *estimate = *seen ? alpha * burst + (1 - alpha) * *estimate : burst;
+    *seen = 1;
+}
+
+/**
+ * @brief Record the actual burst of a finished process that was predicted `predicted` ticks
+ */
+void predictor_observe(Predictor* predictor, const Process* proc, int predicted) {
+    int c = predictor_class(predictor, proc);
+    predictor_average(&predictor->estimate[c], &predictor->seen[c], predictor->alpha, proc->runtime);
+    predictor_average(&predictor->overall, &predictor->overall_seen, predictor->alpha, proc->runtime);
+
+    int error = predicted - proc->runtime;
+    running_stat_push(&predictor->error, error);
+    running_stat_push(&predictor->abs_error, abs(error));
+    running_stat_push(&predictor->relative_error, (double)abs(error) / proc->runtime);
+}
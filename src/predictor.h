@@ -0,0 +1,44 @@
+#ifndef PREDICTOR_H
+#define PREDICTOR_H
+
+#include "process.h"
+#include "stats.h"
+
+/**
+ * Burst length prediction by exponential averaging, per job class:
+ * tau(n+1) = alpha * t(n) + (1 - alpha) * tau(n), where t(n) is the last burst of the class.
+ * A class without history starts from the average over every class, and from
+ * PREDICTOR_DEFAULT_BURST before any burst was seen at all.
+ */
+
+#define PREDICTOR_CLASSES 11       // priorities 0..9 and 10+, or the JOB_SIZE_CLASSES memory size classes
+#define PREDICTOR_DEFAULT_BURST 10 // first guess, the generator's default mean runtime
+
+typedef enum PredictorKey {
+    PREDICT_BY_PRIORITY, // processes of the same priority level share a history
+    PREDICT_BY_SIZE      // processes of the same power-of-two memory size class share a history
+} PredictorKey;
+
+typedef struct Predictor {
+    double alpha; // weight of the latest burst, 0 disables prediction (the true runtime is used)
+    PredictorKey key;
+
+    double estimate[PREDICTOR_CLASSES];
+    int seen[PREDICTOR_CLASSES];
+    double overall; // estimate over every class
+    int overall_seen;
+
+    // Prediction error of finished processes, predicted - actual
+    RunningStat error;
+    RunningStat abs_error;
+    RunningStat relative_error; // |predicted - actual| / actual
+} Predictor;
+
+int parse_predictor(const char* spec, Predictor* predictor);
+void predictor_init(Predictor* predictor, double alpha, PredictorKey key);
+int predictor_enabled(const Predictor* predictor);
+int predictor_estimate(const Predictor* predictor, const Process* proc);
+void predictor_observe(Predictor* predictor, const Process* proc, int predicted);
+const char* predictor_key_name(PredictorKey key);
+
+#endif /* PREDICTOR_H */
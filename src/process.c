@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <unistd.h> // Added for getpid() function
 #include "process.h"
+#include "logger.h"
 
 #define RED     "\x1b[31m"
 #define GREEN   "\x1b[32m"
@@ -29,7 +30,7 @@ void handle_sigcont(int signum)
     // Re-sync with clock when the process is continued
     sync_clk();
     last_clk = get_clk(); // Reset last_clk to current time to avoid immediate tick
-    printf(YELLOW "PROCESS (PID %d): Re-synchronized with clock at time %d" RESET "\n", getpid(), last_clk);
+    LOG_TRACE(YELLOW "PROCESS (PID %d): Re-synchronized with clock at time %d" RESET "\n", getpid(), last_clk);
 }
 
 /**
@@ -53,7 +54,7 @@ void run_process(int runtime, int sch_pid)
     raise(SIGSTOP);
 
     // Initial synchronization
-    printf(YELLOW "PROCESS (PID %d): Started Running at %d " RESET "\n", getpid(), get_clk());
+    LOG_DEBUG(YELLOW "PROCESS (PID %d): Started Running at %d " RESET "\n", getpid(), get_clk());
 
     while (runtime > 0)
     {
@@ -69,7 +70,7 @@ void run_process(int runtime, int sch_pid)
         usleep(10000);
     }
 
-    printf(YELLOW "PROCESS (PID %d): Process %d finished execution at time %d" RESET "\n", getpid(), getpid(), get_clk());
+    LOG_DEBUG(YELLOW "PROCESS (PID %d): Process %d finished execution at time %d" RESET "\n", getpid(), getpid(), get_clk());
 
     destroy_clk(0);
     exit(EXIT_SUCCESS);
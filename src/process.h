@@ -14,6 +14,12 @@ typedef struct Process
     int runtime;
     int priority; // 0 serves as highest priority
     int memory_size; // needed memory by process - max is 256
+    int deadline; // absolute completion deadline, 0 for none (input files give it relative to arrival)
+    int period; // period of the periodic task that released the job, 0 for aperiodic processes
+    struct IoBurst* io; // I/O requests between its CPU bursts (owned by the process list), NULL for a single CPU burst
+    int io_count;
+    int group; // index in task_groups, 0 for the default group
+    unsigned int affinity; // CPUs the process may run on (bit i for CPU i), 0 for any CPU
 } Process;
 
 #endif
\ No newline at end of file
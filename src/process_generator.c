@@ -7,6 +7,9 @@
 #include <sys/ipc.h>   // For IPC_CREAT, etc.
 #include <sys/msg.h>   // For message queue functions
 #include <sys/wait.h>  // for waitpid
+#include <sys/stat.h>  // for mkdir
+#include <errno.h>
+#include <limits.h>    // for PATH_MAX
 
 #include "clk.h"
 #include "process.h"
@@ -15,13 +18,26 @@
 #include "DS/IQueue.h"
 #include "PCB.h"
 #include "buddy_memory.h"
-#include "DS/linked_list.h"
 #include "memory_manager.h"
+#include "stats.h"
+#include "workload.h"
+#include "Algorithms/policy.h"
+#include "sim_engine.h"
+#include "sweep.h"
+#include "logger.h"
 
 void handle_child_exit(int signum);
 void clear_and_exit(int);
 void fork_and_send(Process * proc , Block * allocated_block);
 void create_processes();
+void create_open_loop_processes();
+void admit_waiting_processes();
+void send_no_more_processes();
+int run_engine(char* scheduling_algorithm, int quantum, char* input_file);
+int run_sweep_mode(char* algorithms, char* input_file);
+int enter_run_directory(const char* directory, char** input_file);
+int load_task_set(const char* task_file);
+int compare_arrival(const void* a, const void* b);
 void parse_args(int argc, char* argv[], char** scheduling_algo, char** input_file, int* quantum);
 pid_t clk_pid = -1;
 int sch_pid = -1; // Scheduler process id
@@ -32,11 +48,56 @@ int process_count = 0;        // Number of processes
 
 int msqid;   // Message queue id
 
-LinkedList *waiting_list = NULL;
+OrderQueue *waiting = NULL; // processes waiting for memory by buddy order
+static int memory_held = 0; // aging: a process that waited too long holds the freed memory
+
+// Open-loop mode: arrivals are synthesized instead of read from a file
+static char* arrival_spec = NULL;             // -r <rate> or arrival process spec
+static char* runtime_spec = "exp:10";         // -R <distribution>
+static char* priority_spec = "zipf:1:11";     // -P <distribution>
+static char* memory_spec = "lognormal:4:0.8"; // -M <distribution>
+static char* slack_spec = NULL;               // -L <distribution>, deadline slack (no deadlines by default)
+static int periodic_input = 0;                // -T <file>, the input file is a periodic task set
+static PeriodicTask* tasks = NULL;            // its tasks, expanded into jobs as the run goes
+static int task_count = 0;
+static unsigned long long seed = 1;           // -S <seed>
+static int duration = 0;                      // -d <ticks>, 0 runs until interrupted
+static int report_interval = 0;               // -i <ticks>, scheduler rolling report period
+static int engine_mode = 0;                   // -e, run in-process on the simulation engine (the default)
+static int multi_process = 0;                 // -p, fork the clock, scheduler and processes instead
+static char* run_directory = NULL;            // -D <dir>, working directory for this run's logs
+static AdmissionMode admission = ADMISSION_FLAG; // -a <mode>, EDF deadline admission control
+static int aging_interval = 0;                // -g <ticks>, HPF aging period, 0 disables aging
+static SimCosts costs;                        // -C <costs>, engine overhead cost model
+static int costs_set = 0;
+static Predictor predictor;                   // -E <alpha>[,priority|size], srtn / sjf / hrrn burst prediction
+static int io_models_set = 0;                 // -I <device>=<distribution> and -K <disk>=<policy>, device models
+static int groups_set = 0;                    // -G <group>=<shares>[,quota=,period=], task group fair share
+static char* cpu_spec = NULL;                 // -c <count>[x<speed>],..., simulated CPUs
+static SimNuma numa = { 1, NUMA_LOCAL, 1.5 }; // -N <nodes>[,policy=,remote=], NUMA memory nodes
+static int numa_set = 0;
+static AdmitConfig admit = { ADMIT_OLDEST, 100 }; // -W <policy>[,age=<ticks>], which waiting process gets freed memory
+static SimSwap swap = { 0, 1 };                // -w <bandwidth>[,latency=<ticks>], swap device
+
+// Sweep mode: -s and -q take lists, one engine run per configuration
+static int sweep_mode = 0;                    // -x
+static char* quantum_list = "1";              // -q <list>
+static char* memory_size_list = "1024";       // -m <list>
+static char* allocator_list = "buddy";        // -A <list>
+static int sweep_threads = 0;                 // -j <threads>, 0 uses every core
+static char* sweep_output = "sweep.csv";      // -o <file>, .json writes JSON lines
+
+static int open_loop();
+static int load_trace(char* input_file);
+static void engine_config(SimConfig* config, char* scheduling_algorithm, int quantum);
+static double oracle_wta(SimConfig config);
+
+RunningStat dispatch_lag;     // Send time - arrival time of every dispatched process
+Histogram dispatch_lag_hist;
 
 int main(int argc, char* argv[]) {
 
-    printf("PCB size: %zu, Process size: %zu\n", sizeof(PCB), sizeof(Process));
+    LOG_DEBUG("PCB size: %zu, Process size: %zu\n", sizeof(PCB), sizeof(Process));
 
     char* scheduling_algorithm; // Scheduling algorithm
     char* input_file;           // Input file name
@@ -45,6 +106,87 @@ int main(int argc, char* argv[]) {
     // Set arguments
     parse_args(argc, argv, &scheduling_algorithm, &input_file, &quantum);
 
+    if (run_directory != NULL && enter_run_directory(run_directory, &input_file) != 0) {
+        exit(EXIT_FAILURE);
+    }
+
+    if (periodic_input && load_task_set(input_file) != 0) {
+        exit(EXIT_FAILURE);
+    }
+
+    if (sweep_mode) {
+        return run_sweep_mode(scheduling_algorithm, input_file);
+    }
+
+    if (!multi_process) {
+        return run_engine(scheduling_algorithm, quantum, input_file);
+    }
+
+    if (open_loop()) {
+        LOG_INFO(MAGENTA "P GEN  : Open-loop load %s for %s" RESET "\n", tasks != NULL ? input_file : arrival_spec,
+            duration > 0 ? "a fixed duration" : "ever");
+        for (int i = 0; i < task_count; i++) {
+            if (tasks[i].memory_size > MAX_SIZE) {
+                fprintf(stderr, "Task %d needs %d bytes of memory, more than the %d bytes of the multi-process simulation.\n",
+                    tasks[i].id, tasks[i].memory_size, MAX_SIZE);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    else if (read_input_file(input_file, &process_list, &process_count) == 0) {
+        LOG_INFO(MAGENTA "P GEN  : Processes read from file Succesfully" RESET "\n");
+        // Like sim_submit, skip a process larger than the memory: it would wait for memory
+        // forever, and under -W aging hold every admission behind it
+        int kept = 0;
+        for (int i = 0; i < process_count; i++) {
+            if (process_list[i].memory_size > MAX_SIZE) {
+                LOG_ERROR(MAGENTA "P GEN  : Skipping invalid process %d" RESET "\n", process_list[i].id);
+                free(process_list[i].io);
+                continue;
+            }
+            process_list[kept++] = process_list[i];
+        }
+        process_count = kept;
+
+        for (int i = 0; i < process_count; i++) {
+            if (process_list[i].io_count > 0) {
+                fprintf(stderr, "I/O bursts (process %d) are simulated by the simulation engine only, drop -p.\n", process_list[i].id);
+                exit(EXIT_FAILURE);
+            }
+            if (process_list[i].affinity != 0) {
+                fprintf(stderr, "CPU affinity (process %d) is simulated by the simulation engine only, drop -p.\n", process_list[i].id);
+                exit(EXIT_FAILURE);
+            }
+            if (process_list[i].group != 0) {
+                fprintf(stderr, "Task groups (process %d) are scheduled by the simulation engine only, drop -p.\n", process_list[i].id);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    else {
+        LOG_ERROR(MAGENTA "P GEN  : Error reading input file." RESET "\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Line buffered: forked children must not inherit (and repeat) unflushed output
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    // Lead our own process group so killpg() at the end reaches only this run
+    if (getpgrp() != getpid() && setpgid(0, 0) == -1) {
+        perror(RED "P GEN  : setpgid failed" RESET);
+        exit(EXIT_FAILURE);
+    }
+
+    // Private clock, PCB table and message queue, inherited by every forked child of this run only
+    create_clk();
+    create_pcb_table();
+    msqid = msgget(IPC_PRIVATE, IPC_CREAT | 0600);
+    if (msqid == -1) {
+        perror("msgget failed");
+        exit(1);
+    }
+    LOG_INFO(MAGENTA "P GEN  : Run %d (message queue %d)" RESET "\n", (int)getpid(), msqid);
+
     clk_pid = fork();
     if (clk_pid == 0) // Child (CLK)
     {
@@ -58,176 +200,826 @@ int main(int argc, char* argv[]) {
         signal(SIGCHLD , handle_child_exit);
         sync_clk();
 
-        if (read_input_file(input_file, &process_list, &process_count) == 0) {
-            printf(MAGENTA "P GEN  : Processes read from file Succesfully" RESET "\n");
-        }
-        else {
-            fprintf(stderr, MAGENTA "P GEN  : Error reading input file." RESET "\n");
-            exit(EXIT_FAILURE);
-        }
-
-        printf(MAGENTA "P GEN  : Scheduling algorithm selected: %s" RESET "\n", scheduling_algorithm);
+        LOG_INFO(MAGENTA "P GEN  : Scheduling algorithm selected: %s" RESET "\n", scheduling_algorithm);
 
         // Fork scheduler
         sch_pid = fork();
         if (sch_pid == -1) {
-            fprintf(stderr, MAGENTA "P GEN  : Error in fork" RESET "\n");
+            LOG_ERROR(MAGENTA "P GEN  : Error in fork" RESET "\n");
             exit(EXIT_FAILURE);
         }
         else if (sch_pid == 0) // Child process
         {
             signal(SIGINT, SIG_DFL);
-            run_scheduler(scheduling_algorithm, quantum);
+            run_scheduler(scheduling_algorithm, quantum, report_interval, msqid, admission, aging_interval, &predictor);
             return 0; // Scheduler process
         }
 
-        // Create message queue to send processes
-        key_t key = ftok("keyfile", 'A');
-        msqid = msgget(key, IPC_CREAT | 0666);
-
-        if (msqid == -1) {
-            perror("msgget failed");
-            exit(1);
-        }
-
         // Create the processes in their arrival time
         init_memory_manager();
-        waiting_list = create_linked_list();
-        create_processes();
+        waiting = order_queue();
+        if (open_loop()) {
+            create_open_loop_processes();
+        }
+        else {
+            create_processes();
+        }
 
         int status;
         waitpid(sch_pid, &status, 0);
 
+        dispatch_perf_out(&dispatch_lag, &dispatch_lag_hist);
+        memory_perf_out(&memory_stats, &admit, MAX_SIZE, memory_stats.used.changed_at);
+
+        // Replay the workload on the engine with the true runtimes to compare against
+        if (predictor_enabled(&predictor) && (!open_loop() || duration > 0)
+            && (process_list != NULL || load_trace(input_file) == 0)) {
+            SimConfig config;
+            engine_config(&config, scheduling_algorithm, quantum);
+            oracle_perf_out(oracle_wta(config));
+        }
+
         destroy_clk(1);
     }
 }
 
 /**
- * @brief Set program arguments (scheduling algorithm and input file)
+ * @brief Whether arrivals are synthesized (-r or -T) rather than read from a process file
+ */
+static int open_loop() {
+    return arrival_spec != NULL || tasks != NULL;
+}
+
+/**
+ * @brief Initialize the open-loop workload from the periodic task set (-T)
+ * or from the -r/-R/-P/-M/-S/-L options
+ *
+ * @return int 0 for success, 1 for an invalid spec
+ */
+static int init_open_loop_workload(WorkloadSpec* spec) {
+    if (tasks != NULL) {
+        return workload_init_periodic(spec, tasks, task_count);
+    }
+
+    // A plain number is a Poisson rate
+    static char rate_spec[64];
+    char* end;
+    strtod(arrival_spec, &end);
+    if (*end == '\0') {
+        snprintf(rate_spec, sizeof(rate_spec), "poisson:%s", arrival_spec);
+        arrival_spec = rate_spec;
+    }
+
+    if (workload_init(spec, seed, arrival_spec, runtime_spec, priority_spec, memory_spec) != 0) {
+        return 1;
+    }
+    if (slack_spec != NULL && workload_set_deadline(spec, slack_spec) != 0) {
+        workload_free(spec);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Print usage and exit
+ */
+static void usage() {
+    fprintf(stderr, MAGENTA "P GEN  : Usage: ./os-sim -s <scheduling-algorithm> [-q <quantum>] -f <processes-text-file>" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        ./os-sim -s <scheduling-algorithm> [-q <quantum>] -r <rate | arrival spec> [-d <ticks>]" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        ./os-sim -s <scheduling-algorithm> -T <periodic-task-file> [-d <ticks>]" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        [-R <runtime dist>] [-P <priority dist>] [-M <memory dist>] [-L <deadline slack dist>] [-S <seed>]" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -a <off | flag | reject> sets what edf does with a deadline it cannot guarantee (default flag)" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -g <ticks> ages hpf: a waiting process gains one priority level every <ticks> (default off)" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -E <alpha>[,priority | size] makes srtn, sjf and hrrn order on bursts predicted by exponential averaging per priority or memory size class" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -W <oldest | best | largest | aging>[,age=<ticks>] picks which process waiting for memory gets freed memory (default oldest)" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -l <off | error | info | debug | trace> sets the log level (default info)" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -D <dir> writes this run's logs to <dir> (created if missing)" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -p runs the multi-process simulation (clock, scheduler and processes over IPC) instead of the simulation engine" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -x sweeps -s <algorithms> -q <quanta> [-m <memory sizes>] [-A <allocators>] [-j <threads>] [-o <file>]" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -i <ticks> prints rolling throughput, queue depth and percentiles (-p only)" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        Engine only (not with -p):" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -I <device>=<service time dist> models a device for the I/O bursts of the input file (repeatable)" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -K <disk>=<fcfs | sstf | scan | cscan | look | clook>[,cylinders=<n>,seek=<ticks per cylinder>,settle=<ticks>,rotation=<ticks>] makes a device a disk" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -G <group>=<shares>[,quota=<ticks>,period=<ticks>] weights a task group of the input file, optionally capped per period (repeatable)" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -c <count>[x<speed>][,<count>x<speed>...] simulates CPUs of the given speeds sharing the ready queue, e.g. 2x2,4" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -N <nodes>[,policy=<local | strict | interleave>,remote=<slowdown>] splits the CPUs into NUMA nodes with a memory of their own each" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -w <bytes per tick>[,latency=<ticks>] swaps blocked or less urgent processes out to make room for waiting ones" RESET "\n");
+    fprintf(stderr, MAGENTA "P GEN  :        -C switch=<ticks>,dispatch=<ticks>,migrate=<ticks>,alloc=<ticks> charges overhead in simulated time" RESET "\n");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Set program arguments (scheduling algorithm and input file or open-loop load)
  *
  * @param[in] int argc, char *argv[], char **scheduling_algorithm and char **input_file
  */
 void parse_args(int argc, char* argv[], char** scheduling_algo, char** input_file, int* quantum) {
-    // Check the count of arguments and -s flag
-    if (argc != 5 && argc != 7 || strcmp(argv[1], "-s") != 0) {
-        fprintf(stderr, MAGENTA "P GEN  : Usage: ./os-sim -s <scheduling-algorithm> [-q <quantum>] -f <processes-text-file>" RESET "\n");
+    *scheduling_algo = NULL;
+    *input_file = NULL;
+    *quantum = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:q:f:T:r:d:R:P:M:S:i:epxm:A:j:o:D:l:L:a:g:C:E:I:K:G:c:N:W:w:")) != -1) {
+        switch (opt) {
+        case 's': *scheduling_algo = optarg; break;
+        case 'q': *quantum = atoi(optarg); quantum_list = optarg; break;
+        case 'f': *input_file = optarg; break;
+        case 'T': *input_file = optarg; periodic_input = 1; break;
+        case 'r': arrival_spec = optarg; break;
+        case 'd': duration = atoi(optarg); break;
+        case 'R': runtime_spec = optarg; break;
+        case 'P': priority_spec = optarg; break;
+        case 'M': memory_spec = optarg; break;
+        case 'S': seed = strtoull(optarg, NULL, 10); break;
+        case 'i': report_interval = atoi(optarg); break;
+        case 'e': engine_mode = 1; break;
+        case 'p': multi_process = 1; break;
+        case 'x': sweep_mode = 1; break;
+        case 'm': memory_size_list = optarg; break;
+        case 'A': allocator_list = optarg; break;
+        case 'j': sweep_threads = atoi(optarg); break;
+        case 'o': sweep_output = optarg; break;
+        case 'D': run_directory = optarg; break;
+        case 'L': slack_spec = optarg; break;
+        case 'g': aging_interval = atoi(optarg); break;
+        case 'a':
+            if (parse_admission(optarg, &admission) != 0) {
+                usage();
+            }
+            break;
+        case 'C':
+            if (parse_costs(optarg, &costs) != 0) {
+                usage();
+            }
+            costs_set = 1;
+            break;
+        case 'E':
+            if (parse_predictor(optarg, &predictor) != 0) {
+                usage();
+            }
+            break;
+        case 'I':
+            if (parse_io_device(optarg) != 0) {
+                usage();
+            }
+            io_models_set = 1;
+            break;
+        case 'K':
+            if (parse_io_disk(optarg) != 0) {
+                usage();
+            }
+            io_models_set = 1;
+            break;
+        case 'G':
+            if (parse_task_group(optarg) != 0) {
+                usage();
+            }
+            groups_set = 1;
+            break;
+        case 'c': {
+            SimConfig cpus;
+            if (parse_cpus(optarg, &cpus) != 0) {
+                usage();
+            }
+            cpu_spec = optarg;
+            break;
+        }
+        case 'N':
+            if (parse_numa(optarg, &numa) != 0) {
+                usage();
+            }
+            numa_set = 1;
+            break;
+        case 'W':
+            if (parse_admit_policy(optarg, &admit) != 0) {
+                usage();
+            }
+            break;
+        case 'w':
+            if (parse_swap(optarg, &swap) != 0) {
+                usage();
+            }
+            break;
+        case 'l':
+            if (parse_log_level(optarg, &log_level) != 0) {
+                usage();
+            }
+            break;
+        default: usage();
+        }
+    }
+
+    if (*scheduling_algo == NULL || optind != argc || (*input_file == NULL) == (arrival_spec == NULL)) {
+        usage();
+    }
+
+    if (multi_process && (engine_mode || sweep_mode)) {
+        fprintf(stderr, "The multi-process simulation (-p) cannot run on the engine (-e) or sweep (-x).\n");
+        exit(EXIT_FAILURE);
+    }
+    if (report_interval > 0 && !multi_process) {
+        fprintf(stderr, "Rolling reports (-i) are printed by the multi-process scheduler only, add -p.\n");
         exit(EXIT_FAILURE);
     }
 
-    *scheduling_algo = argv[2];
+    // Overhead is charged in simulated time, the multi-process simulation runs on the real clock
+    if (costs_set && multi_process) {
+        fprintf(stderr, "Overhead costs (-C) are charged by the simulation engine only, drop -p.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (io_models_set && multi_process) {
+        fprintf(stderr, "I/O devices (-I, -K) are simulated by the simulation engine only, drop -p.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (cpu_spec != NULL && multi_process) {
+        fprintf(stderr, "Multiple CPUs (-c) are simulated by the simulation engine only, drop -p.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (groups_set && multi_process) {
+        fprintf(stderr, "Task groups (-G) are scheduled by the simulation engine only, drop -p.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (numa_set && multi_process) {
+        fprintf(stderr, "NUMA nodes (-N) are simulated by the simulation engine only, drop -p.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (swap.bandwidth > 0 && multi_process) {
+        fprintf(stderr, "Swapping (-w) is simulated by the simulation engine only, drop -p.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (numa_set) {
+        SimConfig cpus;
+        sim_config_init(&cpus);
+        if (cpu_spec != NULL) {
+            parse_cpus(cpu_spec, &cpus);
+        }
+        if (numa.nodes > cpus.cpu_count) {
+            fprintf(stderr, "Each NUMA node (-N) needs a CPU of its own, add CPUs with -c.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Sweep lists are validated by the sweep itself
+    if (sweep_mode) {
+        if (arrival_spec != NULL && duration == 0) {
+            fprintf(stderr, "Open-loop load in a sweep needs a duration (-d).\n");
+            exit(EXIT_FAILURE);
+        }
+        return;
+    }
 
     // Check the algorithm
-    if (strcmp(*scheduling_algo, "rr") != 0 && strcmp(*scheduling_algo, "hpf") != 0 && strcmp(*scheduling_algo, "srtn") != 0) {
+    SchedulingAlgorithm algorithm;
+    if (parse_algorithm(*scheduling_algo, &algorithm) != 0) {
         fprintf(stderr, MAGENTA "P GEN  : Please enter a valid algorithm!" RESET "\n");
-        fprintf(stderr, MAGENTA "P GEN  : Valid algorithms: (rr - hpf - srtn)" RESET "\n");
+        fprintf(stderr, MAGENTA "P GEN  : Valid algorithms: (rr - hpf - srtn - edf - rm - lottery - stride - sjf - hrrn)" RESET "\n");
         exit(EXIT_FAILURE);
     }
 
     // Check for algorithm arguments
-    if (strcmp(*scheduling_algo, "rr") == 0) {
-        if (argc != 7 || strcmp(argv[3], "-q") != 0 || strcmp(argv[5], "-f") != 0) {
-            fprintf(stderr, "Algorithm Usage: ./os-sim -s rr -q <quantum> -f <processes-text-file>\n");
-            exit(EXIT_FAILURE);
-        }
-
-        *quantum = atoi(argv[4]);
+    if (policy_uses_quantum(algorithm)) {
         if (*quantum <= 0) {
+            fprintf(stderr, "Algorithm Usage: ./os-sim -s %s -q <quantum> -f <processes-text-file>\n", *scheduling_algo);
             fprintf(stderr, "Quantum must be a positive integer.\n");
             exit(EXIT_FAILURE);
         }
-        *input_file = argv[6];
+    }
+
+    if (predictor_enabled(&predictor) && !policy_uses_burst(algorithm)) {
+        fprintf(stderr, "Runtime prediction (-E) applies to srtn, sjf and hrrn only.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!multi_process && arrival_spec != NULL && duration == 0) {
+        fprintf(stderr, "Open-loop load on the simulation engine needs a duration (-d), or add -p to run until interrupted.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (duration < 0 || report_interval < 0 || aging_interval < 0) {
+        fprintf(stderr, "Duration, report interval and aging interval must be non-negative.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Create the run directory (and its parents) and make it the working directory
+ * @details Every log of the run is written relative to it, so concurrent runs given
+ * different directories never overwrite each other. The input file is resolved first.
+ *
+ * @return int 0 for success, 1 for error
+ */
+int enter_run_directory(const char* directory, char** input_file) {
+    static char input_path[PATH_MAX];
+    if (*input_file != NULL && realpath(*input_file, input_path) != NULL) {
+        *input_file = input_path;
+    }
+
+    char path[PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s", directory) >= (int)sizeof(path)) {
+        LOG_ERROR(RED "P GEN  : Run directory path too long" RESET "\n");
+        return 1;
+    }
+    for (char* c = path + 1; ; c++) {
+        if (*c == '/' || *c == '\0') {
+            char end = *c;
+            *c = '\0';
+            if (mkdir(path, 0755) == -1 && errno != EEXIST) {
+                perror(RED "P GEN  : Failed to create run directory" RESET);
+                return 1;
+            }
+            *c = end;
+            if (end == '\0') {
+                break;
+            }
+        }
+    }
+
+    if (chdir(directory) == -1) {
+        perror(RED "P GEN  : Failed to enter run directory" RESET);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read the periodic task set (-T), print its schedulability analysis and default the horizon
+ * @details Liu-Layland utilization bound and exact response-time analysis for rate-monotonic
+ * priorities, utilization (density for constrained deadlines) test for EDF. Without -d the
+ * run covers the largest phase plus one hyperperiod.
+ *
+ * @return int 0 for success, 1 for error
+ */
+int load_task_set(const char* task_file) {
+    if (read_task_file(task_file, &tasks, &task_count) != 0) {
+        LOG_ERROR(MAGENTA "P GEN  : Error reading task file." RESET "\n");
+        return 1;
+    }
+
+    int max_phase = 0;
+    int implicit_deadlines = 1;
+    for (int i = 0; i < task_count; i++) {
+        max_phase = tasks[i].phase > max_phase ? tasks[i].phase : max_phase;
+        implicit_deadlines &= tasks[i].deadline == tasks[i].period;
+    }
+    long long hyperperiod = periodic_hyperperiod(tasks, task_count, INT_MAX / 2);
+
+    double utilization = periodic_utilization(tasks, task_count);
+    double density = periodic_density(tasks, task_count);
+    double bound = liu_layland_bound(task_count);
+
+    if (hyperperiod > 0) {
+        LOG_INFO(MAGENTA "P GEN  : %d periodic tasks, utilization %.3f, hyperperiod %lld" RESET "\n", task_count, utilization, hyperperiod);
     }
     else {
-        if (argc != 5 || strcmp(argv[3], "-f") != 0) {
-            fprintf(stderr, "Usage: ./os-sim -s <scheduling-algorithm> [-q <quantum>] -f <processes-text-file>\n");
-            exit(EXIT_FAILURE);
+        LOG_INFO(MAGENTA "P GEN  : %d periodic tasks, utilization %.3f, hyperperiod above %d" RESET "\n", task_count, utilization, INT_MAX / 2);
+    }
+    LOG_INFO(MAGENTA "P GEN  : RM  Liu-Layland bound %.3f: %s" RESET "\n", bound,
+        !implicit_deadlines ? "not applicable (constrained deadlines)" :
+        utilization <= bound ? "schedulable" : "inconclusive");
+
+    int rta_schedulable = 1;
+    for (int i = 0; i < task_count; i++) {
+        int response = periodic_response_time(tasks, task_count, i);
+        rta_schedulable &= response >= 0;
+        if (response >= 0) {
+            LOG_INFO(MAGENTA "P GEN  : RM  task %d: C = %d T = %d D = %d worst-case response %d" RESET "\n",
+                tasks[i].id, tasks[i].wcet, tasks[i].period, tasks[i].deadline, response);
+        }
+        else {
+            LOG_INFO(MAGENTA "P GEN  : RM  task %d: C = %d T = %d D = %d misses its deadline" RESET "\n",
+                tasks[i].id, tasks[i].wcet, tasks[i].period, tasks[i].deadline);
         }
-        *input_file = argv[4];
     }
+    LOG_INFO(MAGENTA "P GEN  : RM  response-time analysis: %s" RESET "\n", rta_schedulable ? "schedulable" : "not schedulable");
+    LOG_INFO(MAGENTA "P GEN  : EDF %s %.3f: %s" RESET "\n", implicit_deadlines ? "utilization" : "density",
+        density, density <= 1 ? "schedulable" : implicit_deadlines ? "not schedulable" : "inconclusive");
+
+    if (duration == 0) {
+        if (hyperperiod < 0 || max_phase + hyperperiod > INT_MAX / 2) {
+            LOG_ERROR(MAGENTA "P GEN  : Hyperperiod too large, give the horizon with -d" RESET "\n");
+            return 1;
+        }
+        duration = max_phase + (int)hyperperiod;
+    }
+    return 0;
+}
+
+/**
+ * @brief Open an output file or exit
+ */
+static FILE* open_output(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        perror(RED "P GEN  : Failed to create output file" RESET);
+        exit(EXIT_FAILURE);
+    }
+    return file;
+}
+
+/**
+ * @brief Engine configuration of the command line options
+ */
+static void engine_config(SimConfig* config, char* scheduling_algorithm, int quantum) {
+    sim_config_init(config);
+    parse_algorithm(scheduling_algorithm, &config->algorithm);
+    config->admission = admission;
+    config->aging_interval = aging_interval;
+    config->costs = costs;
+    config->predict_alpha = predictor.alpha;
+    config->predict_key = predictor.key;
+    config->seed = seed;
+    config->io_devices = io_devices;
+    config->io_device_count = io_device_count;
+    config->task_groups = task_groups;
+    config->task_group_count = task_group_count;
+    if (cpu_spec != NULL) {
+        parse_cpus(cpu_spec, config);
+    }
+    config->numa = numa;
+    config->admit = admit;
+    config->swap = swap;
+    if (quantum > 0) {
+        config->quantum = quantum;
+    }
+}
+
+/**
+ * @brief Read the whole workload into process_list, sorted by arrival
+ * @details The open-loop load is synthesized for `duration` ticks.
+ *
+ * @return int 0 for success, 1 for error
+ */
+static int load_trace(char* input_file) {
+    if (open_loop()) {
+        WorkloadSpec spec;
+        if (init_open_loop_workload(&spec) != 0) {
+            return 1;
+        }
+
+        int capacity = 64;
+        process_list = malloc(capacity * sizeof(Process));
+        Process proc;
+        workload_next(&spec, &proc);
+        while (proc.arrival_time < duration) {
+            if (process_count == capacity) {
+                capacity *= 2;
+                process_list = realloc(process_list, capacity * sizeof(Process));
+            }
+            process_list[process_count++] = proc;
+            workload_next(&spec, &proc);
+        }
+        workload_free(&spec);
+    }
+    else if (read_input_file(input_file, &process_list, &process_count) != 0) {
+        LOG_ERROR(MAGENTA "P GEN  : Error reading input file." RESET "\n");
+        return 1;
+    }
+    qsort(process_list, process_count, sizeof(Process), compare_arrival);
+    return 0;
+}
+
+/**
+ * @brief Average WTA of process_list scheduled on the true runtimes (the oracle of a predicted run)
+ */
+static double oracle_wta(SimConfig config) {
+    config.predict_alpha = 0;
+    config.scheduler_log = NULL;
+    config.memory_log = NULL;
+    config.execution_log = NULL;
+
+    Sim* sim = sim_create(&config);
+    if (sim == NULL) {
+        return 0;
+    }
+    double wta = sim_run_trace(sim, process_list, process_count) < 0 ? 0 : sim_stats(sim)->perf.wta.mean;
+    sim_destroy(sim);
+    return wta;
+}
+
+/**
+ * @brief Run the whole simulation in this process on the simulation engine (the default)
+ * @details Reads the same input (or synthesizes the open-loop load for -d ticks)
+ * and writes scheduler.log, memory.log, execution_log.txt and scheduler.perf in the
+ * format of the multi-process simulation (-p), whose schedules may differ. A predicted run (-E) is replayed on the true
+ * runtimes and the oracle's average WTA is added to scheduler.perf.
+ *
+ * @return int exit code
+ */
+int run_engine(char* scheduling_algorithm, int quantum, char* input_file) {
+    WorkloadSpec spec;
+    if (open_loop()) {
+        if (init_open_loop_workload(&spec) != 0) {
+            return EXIT_FAILURE;
+        }
+    }
+    else if (read_input_file(input_file, &process_list, &process_count) != 0) {
+        LOG_ERROR(MAGENTA "P GEN  : Error reading input file." RESET "\n");
+        return EXIT_FAILURE;
+    }
+
+    // After the input, which registers the devices its bursts name
+    SimConfig config;
+    engine_config(&config, scheduling_algorithm, quantum);
+    config.scheduler_log = open_output("scheduler.log");
+    config.memory_log = open_output("memory.log");
+    config.execution_log = open_output("execution_log.txt");
+    write_scheduler_log_header(config.scheduler_log);
+    write_memory_log_header(config.memory_log);
+
+    Sim* sim = sim_create(&config);
+    if (sim == NULL) {
+        LOG_ERROR(MAGENTA "P GEN  : Invalid simulation configuration" RESET "\n");
+        return EXIT_FAILURE;
+    }
+
+    // Submit arrivals in time order, advancing the simulation up to each arrival
+    if (open_loop()) {
+        Process proc;
+        workload_next(&spec, &proc);
+        while (proc.arrival_time < duration) {
+            sim_run_until(sim, proc.arrival_time);
+            sim_submit(sim, &proc);
+            workload_next(&spec, &proc);
+        }
+        workload_free(&spec);
+    }
+    else {
+        qsort(process_list, process_count, sizeof(Process), compare_arrival);
+        for (int i = 0; i < process_count; i++) {
+            sim_run_until(sim, process_list[i].arrival_time);
+            if (sim_submit(sim, &process_list[i]) != 0) {
+                LOG_ERROR(MAGENTA "P GEN  : Skipping invalid process %d" RESET "\n", process_list[i].id);
+            }
+        }
+    }
+    if (sim_run_until(sim, SIM_TIME_MAX) < 0) {
+        LOG_ERROR(MAGENTA "P GEN  : The simulation engine stopped, out of memory" RESET "\n");
+        sim_destroy(sim);
+        free_process_list(process_list, process_count);
+        fclose(config.scheduler_log);
+        fclose(config.memory_log);
+        fclose(config.execution_log);
+        return EXIT_FAILURE;
+    }
+
+    const SimStats* stats = sim_stats(sim);
+    FILE* perf = open_output("scheduler.perf");
+    write_perf(perf, &stats->perf, &stats->jobs, stats->idle_time, stats->overhead_time, stats->end_time * stats->cpu_count);
+    write_cpu_perf(perf, stats->cpu, stats->cpu_count, stats->end_time, config.costs.migration);
+    write_numa_perf(perf, stats->node, stats->node_count, &config.numa, stats->end_time);
+    write_swap_perf(perf, &stats->swap, &config.swap, stats->end_time);
+    write_memory_perf(perf, &stats->memory, &config.admit, stats->node_count * config.memory_size, stats->end_time);
+    write_prediction_perf(perf, &stats->predictor);
+    if (predictor_enabled(&stats->predictor) && (process_list != NULL || load_trace(input_file) == 0)) {
+        write_oracle_perf(perf, oracle_wta(config));
+    }
+    write_io_perf(perf, &stats->io, config.io_devices, config.io_device_count, stats->end_time);
+    write_group_perf(perf, config.task_groups, stats->groups, config.task_group_count, stats->busy_time, stats->end_time);
+    fclose(perf);
+
+    LOG_INFO(MAGENTA "P GEN  : Engine finished %lld processes at time %d" RESET "\n", stats->finished, stats->end_time);
+
+    sim_destroy(sim);
+    free_process_list(process_list, process_count);
+    fclose(config.scheduler_log);
+    fclose(config.memory_log);
+    fclose(config.execution_log);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Run a parameter sweep on the simulation engine (-x)
+ * @details The workload (input file, or the open-loop load for -d ticks) is read once
+ * and replayed by every configuration of the grid.
+ *
+ * @return int exit code
+ */
+int run_sweep_mode(char* algorithms, char* input_file) {
+    if (load_trace(input_file) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    SweepGrid grid;
+    if (sweep_parse_grid(&grid, algorithms, quantum_list, memory_size_list, allocator_list) != 0) {
+        sweep_free_grid(&grid);
+        free_process_list(process_list, process_count);
+        return EXIT_FAILURE;
+    }
+
+    grid.costs = costs;
+    if (cpu_spec != NULL) {
+        SimConfig cpus;
+        parse_cpus(cpu_spec, &cpus);
+        grid.cpu_count = cpus.cpu_count;
+        memcpy(grid.cpu_speed, cpus.cpu_speed, sizeof(grid.cpu_speed));
+    }
+    grid.numa = numa;
+    grid.admit = admit;
+    grid.swap = swap;
+    grid.admission = admission;
+    grid.aging_interval = aging_interval;
+    grid.predict_alpha = predictor.alpha;
+    grid.predict_key = predictor.key;
+    grid.io_devices = io_devices;
+    grid.io_device_count = io_device_count;
+    grid.task_groups = task_groups;
+    grid.task_group_count = task_group_count;
+    int status = run_sweep(&grid, process_list, process_count, sweep_threads, sweep_output);
+
+    sweep_free_grid(&grid);
+    free_process_list(process_list, process_count);
+    return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 volatile sig_atomic_t interrupted = 0;
+
 /**
- * @brief Create all the processes read from input file in their arrival time
- * and send them to the scheduler
+ * @brief Order processes by arrival time (then id) for the arrival index
  */
-void create_processes() {
-    int* processed = calloc(process_count, sizeof(int));
-    int i = 0;
-    Block * fit_memory_block = NULL;
-    Process* waited_fit = NULL;
+int compare_arrival(const void* a, const void* b) {
+    const Process* pa = (const Process*)a;
+    const Process* pb = (const Process*)b;
 
-    
-    while ( (i < process_count || waiting_list->size != 0) && !interrupted) 
+    if (pa->arrival_time != pb->arrival_time) {
+        return pa->arrival_time - pb->arrival_time;
+    }
+    return pa->id - pb->id;
+}
+
+/**
+ * @brief Send the waiting processes the admission policy (-W) picks to the scheduler, as long as one fits
+ */
+void admit_waiting_processes() {
+    Process* waited_fit = get_admissible(waiting, &admit, &memory_held);
+    while (waited_fit != NULL)
     {
-        waited_fit = get_oldest_fit(waiting_list);
-        while (waited_fit != NULL) // waiting list
+        Block* allocated_block = allocate_process_memory(waited_fit->memory_size);
+        if (allocated_block != NULL)
         {
-            fit_memory_block = get_smallest_block(waited_fit);
-            if(fit_memory_block != NULL)
-            {
-                Block* allocated_block = allocate_process_memory(waited_fit->memory_size);
-                printf("Sending to sched from wait queue %d\n", waited_fit->id);
-                fork_and_send(waited_fit, fit_memory_block);
+            LOG_TRACE("Sending to sched from wait queue %d\n", waited_fit->id);
+            fork_and_send(waited_fit, allocated_block);
+            if (open_loop()) {
+                free(waited_fit); // synthesized by the open-loop generator
             }
-            else {
-                printf("NO OLDEST FIT MEMORY");
-            }
-            waited_fit = get_oldest_fit(waiting_list);
         }
-        
-        if (i < process_count && get_clk() == process_list[i].arrival_time && !processed[i]) 
+        else {
+            LOG_TRACE("NO OLDEST FIT MEMORY");
+        }
+        waited_fit = get_admissible(waiting, &admit, &memory_held);
+    }
+}
+
+/**
+ * @brief Create all the processes read from input file in their arrival time
+ * and send them to the scheduler
+ * @details The process list is sorted by arrival once, then on every clock tick all
+ * processes with arrival_time <= now are dispatched as one batch.
+ * Between batches the generator blocks on the clock until the next arrival
+ * (or the next tick while processes wait for memory).
+ */
+void create_processes() {
+    int next = 0; // Next process in the arrival index
+
+    running_stat_init(&dispatch_lag);
+    histogram_init(&dispatch_lag_hist, 1);
+
+    qsort(process_list, process_count, sizeof(Process), compare_arrival);
+
+    while ( (next < process_count || oq_size(waiting) != 0) && !interrupted) 
+    {
+        admit_waiting_processes();
+
+        int current_time = get_clk();
+        while (next < process_count && process_list[next].arrival_time <= current_time)
         {
-            processed[i] = 1;
-            Process* proc = &process_list[i];
-            Block* allocated_block = allocate_process_memory(proc->memory_size);
+            Process* proc = &process_list[next++];
+            // Behind an aged process, newcomers wait too instead of taking the memory it waits for
+            Block* allocated_block = memory_held ? NULL : allocate_process_memory(proc->memory_size);
             if (allocated_block == NULL)
             {
-                printf(MAGENTA "P GEN  : Current time: %d, process %d will be added to waiting list" RESET "\n", get_clk(), proc->id);
-                Node* node = create_node(proc);
-                add_node_to_back(waiting_list, node);
-                i++;
+                LOG_DEBUG(MAGENTA "P GEN  : Current time: %d, process %d will be added to waiting list" RESET "\n", current_time, proc->id);
+                oq_push(waiting, proc, block_order(proc->memory_size), current_time);
+                memory_stats.waited++;
                 continue;
             }
-            printf("Sending to sched from ready queue %d\n", proc->id);
+            LOG_TRACE("Sending to sched from ready queue %d\n", proc->id);
             fork_and_send(proc, allocated_block);
 
-            printf(MAGENTA "P GEN  : Current time: %d, process %d will be sent to schedular" RESET "\n", get_clk(), proc->id);
-            
-            i++;
+            LOG_DEBUG(MAGENTA "P GEN  : Current time: %d, process %d will be sent to schedular" RESET "\n", current_time, proc->id);
         }
-        else
-        {
-            usleep(50000);
+
+        // Waiting processes are retried every tick (or sooner when a child exit interrupts the wait)
+        if (oq_size(waiting) != 0 || next >= process_count) {
+            wait_for_clk(current_time + 1);
+        }
+        else {
+            wait_for_clk(process_list[next].arrival_time);
         }
     }
 
     // Send "no_more_processes" to scheduler
-    if (waiting_list->size == 0)
-       {
-        printf("Sending message");
-        msg_struct msg;
-        memset(&msg, 0, sizeof(msg_struct));
-        msg.mtype = 2;
+    if (oq_size(waiting) == 0) {
+        send_no_more_processes();
+    }
+}
+
+/**
+ * @brief Synthesize arrivals at the target rate (open-loop load) and send them to the scheduler
+ * @details Arrivals come from the same distributions as workload-gen and are dispatched
+ * in per-tick batches like file input. Runs for `duration` ticks, or until interrupted.
+ * Each synthesized process is heap allocated and freed once it has been sent.
+ */
+void create_open_loop_processes() {
+    WorkloadSpec spec;
+    if (init_open_loop_workload(&spec) != 0) {
+        LOG_ERROR(MAGENTA "P GEN  : Invalid open-loop workload" RESET "\n");
+        kill(sch_pid, SIGINT);
+        return;
+    }
 
-        strncpy(msg.data.str, "no_more_processes", 17);
-        msg.data.str[17] = '\0';
+    running_stat_init(&dispatch_lag);
+    histogram_init(&dispatch_lag_hist, 1);
 
-        if (msgsnd(msqid, &msg, sizeof(msg.data.str), 0) == -1) {
-            perror(RED "P GEN  : msgsnd failed" RESET);
+    int start_time = get_clk();
+    Process* next = malloc(sizeof(Process));
+    workload_next(&spec, next);
+    next->arrival_time += start_time;
+    next->deadline += next->deadline > 0 ? start_time : 0;
+
+    while ((duration == 0 || next->arrival_time < start_time + duration || oq_size(waiting) != 0) && !interrupted)
+    {
+        admit_waiting_processes();
+
+        int current_time = get_clk();
+        while ((duration == 0 || next->arrival_time < start_time + duration) && next->arrival_time <= current_time)
+        {
+            Block* allocated_block = memory_held ? NULL : allocate_process_memory(next->memory_size);
+            if (allocated_block == NULL)
+            {
+                oq_push(waiting, next, block_order(next->memory_size), current_time);
+                memory_stats.waited++;
+            }
+            else
+            {
+                fork_and_send(next, allocated_block);
+                free(next);
+            }
+
+            next = malloc(sizeof(Process));
+            workload_next(&spec, next);
+            next->arrival_time += start_time;
+            next->deadline += next->deadline > 0 ? start_time : 0;
+        }
+
+        if (oq_size(waiting) != 0 || (duration != 0 && next->arrival_time >= start_time + duration)) {
+            wait_for_clk(current_time + 1);
+        }
+        else {
+            wait_for_clk(next->arrival_time);
         }
+    }
+
+    free(next);
+    workload_free(&spec);
+
+    if (oq_size(waiting) == 0) {
+        send_no_more_processes();
+    }
+}
+
+/**
+ * @brief Tell the scheduler that no more processes will arrive
+ */
+void send_no_more_processes() {
+    LOG_TRACE("Sending message");
+    msg_struct msg;
+    memset(&msg, 0, sizeof(msg_struct));
+    msg.mtype = 2;
+
+    strncpy(msg.data.str, "no_more_processes", 17);
+    msg.data.str[17] = '\0';
 
-        free(processed);
-       }
+    if (msgsnd(msqid, &msg, sizeof(msg.data.str), 0) == -1) {
+        perror(RED "P GEN  : msgsnd failed" RESET);
+    }
 }
 
 
 void fork_and_send(Process * proc , Block * allocated_block)
 {
+    int slot = pcb_table_acquire();
+    if (slot == -1) {
+        LOG_ERROR(RED "P GEN  : PCB table full, dropping process %d" RESET "\n", proc->id);
+        return_process_memory(allocated_block);
+        return;
+    }
+
     int pid = fork();
 
     if (pid == -1) {
-        fprintf(stderr, RED "P GEN  : Error in fork" RESET "\n");
+        LOG_ERROR(RED "P GEN  : Error in fork" RESET "\n");
+        pcb_table_release(slot, PCB_SLOT_PROCESS | PCB_SLOT_SCHEDULER);
+        return_process_memory(allocated_block);
         return;
     }
     else if (pid == 0) // Child process
@@ -237,32 +1029,46 @@ void fork_and_send(Process * proc , Block * allocated_block)
     }
     // parent process -> process generator
     else {
-        // create new PCB entry for the current process
-        PCB new_pcb;
+        // fill the PCB table entry of the current process in place
+        PCB* new_pcb = pcb_at(slot);
 
-        new_pcb.pid = pid; // pid
-        new_pcb.PDATA = *proc;
-        new_pcb.remaining_time = proc->runtime; // initialized to run time
-        new_pcb.start_time = -1;
-        new_pcb.wait_time = 0;
+        new_pcb->pid = pid; // pid
+        new_pcb->PDATA = *proc;
+        new_pcb->remaining_time = proc->runtime; // initialized to run time
+        new_pcb->start_time = -1;
+        new_pcb->wait_time = 0;
+        new_pcb->state = NULL;
+        new_pcb->pass = 0;
+        new_pcb->share_start = 0;
+        new_pcb->intended_service = 0;
+        new_pcb->predicted_runtime = 0;
+        new_pcb->io_next = 0;
+        new_pcb->io_time = 0;
+        new_pcb->blocked_at = 0;
 
-        assign_memory_block_to_process(&new_pcb, allocated_block);
+        assign_memory_block_to_process(new_pcb, allocated_block);
 
-        printf("Debug: Sending process (ID: %d, Arrival Time: %d, Runtime: %d, PID: %d) to scheduler\n",
-            new_pcb.PDATA.id, new_pcb.PDATA.arrival_time, new_pcb.PDATA.runtime, new_pcb.pid);
+        LOG_TRACE("Debug: Sending process (ID: %d, Arrival Time: %d, Runtime: %d, PID: %d) to scheduler in slot %d\n",
+            new_pcb->PDATA.id, new_pcb->PDATA.arrival_time, new_pcb->PDATA.runtime, new_pcb->pid, slot);
 
-        // send message
+        // send the slot index only
         msg_struct msg;
         memset(&msg, 0, sizeof(msg_struct));
 
         msg.mtype = 1;
-        msg.data.pcb = new_pcb;
+        msg.data.slot = slot;
 
-        if (msgsnd(msqid, &msg, sizeof(msg.data.pcb), 0) == -1) {
+        if (msgsnd(msqid, &msg, sizeof(msg.data.slot), 0) == -1) {
             perror(RED "P GEN  : msgsnd failed" RESET);
+            pcb_table_release(slot, PCB_SLOT_SCHEDULER);
             kill(pid, SIGKILL); // Kill the child process on send failure
+            return;
         }
 
+        int lag = get_clk() - proc->arrival_time;
+        running_stat_push(&dispatch_lag, lag);
+        histogram_record(&dispatch_lag_hist, lag);
+
     }
 }
 
@@ -277,9 +1083,18 @@ void fork_and_send(Process * proc , Block * allocated_block)
 void clear_and_exit(int signum) {
     interrupted = 1;
     signal(SIGINT, SIG_IGN); // Process generator ignores the next signal to avoid clearing twice
-    free_linked_list(waiting_list);
+    signal(SIGCHLD, SIG_DFL); // Reap the scheduler below instead of in handle_child_exit
+    if (waiting != NULL) {
+        oq_free(waiting);
+    }
     killpg(getpgrp(), SIGINT); // Interrupt all children including the clock
     free_memory_manager();
+
+    // The scheduler writes scheduler.perf on SIGINT, append the dispatch lag after it
+    if (sch_pid > 0 && waitpid(sch_pid, NULL, 0) == sch_pid) {
+        dispatch_perf_out(&dispatch_lag, &dispatch_lag_hist);
+        memory_perf_out(&memory_stats, &admit, MAX_SIZE, memory_stats.used.changed_at);
+    }
     // Clear message queue
     if (msgctl(msqid, IPC_RMID, NULL) == -1) {
         perror(RED "P GEN  : Cleaning up (msgctl) failed" RESET);
@@ -297,12 +1112,16 @@ void handle_child_exit(int signum) {
     // Wait for any process to exit without blocking
     while ((exited_pid = waitpid(-1, &status, WNOHANG)) > 0) {
         if (exited_pid != clk_pid && exited_pid != sch_pid) {
-            printf(MAGENTA "P GEN  : Process exited (PID: %d)" RESET "\n", exited_pid);
-            if(deallocate_process_memory(exited_pid) == 1) {
-                printf(MAGENTA "P GEN  : Memory deallocated for process %d" RESET "\n", exited_pid);
+            LOG_DEBUG(MAGENTA "P GEN  : Process exited (PID: %d)" RESET "\n", exited_pid);
+            int slot = pcb_table_find_pid(exited_pid);
+            if (slot != -1 && deallocate_process_memory(slot) == 1) {
+                LOG_DEBUG(MAGENTA "P GEN  : Memory deallocated for process %d" RESET "\n", exited_pid);
             }
             else {
-                printf(MAGENTA "P GEN  : Error deallocating memory for process %d" RESET "\n", exited_pid);
+                LOG_ERROR(MAGENTA "P GEN  : Error deallocating memory for process %d" RESET "\n", exited_pid);
+            }
+            if (slot != -1) {
+                pcb_table_release(slot, PCB_SLOT_PROCESS);
             }
 
         }
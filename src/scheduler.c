@@ -10,6 +10,8 @@
 #include <errno.h>
 #include "file_handlers.h"
 #include "Algorithms/utils.h"
+#include "Algorithms/policy.h"
+#include "logger.h"
 
 IQueue* ready_queue;
 PCB* current_pcb = NULL;
@@ -23,17 +25,35 @@ FILE* execution_log = NULL;    // File to log execution periods
 int last_process_end_time = 0; // Time when the last process ended or scheduler started
 int idle_time = 0;             // CPU idle time
 
+int report_interval = 0;  // Ticks between rolling reports, 0 disables them
+int next_report_time = 0;
+
 int no_more_processes = 0;
 enum SchedulingAlgorithm selected_algorithm;
+AdmissionMode admission = ADMISSION_FLAG; // EDF deadline admission control
+int aging_interval = 0;                   // HPF: ticks of waiting per priority level gained, 0 disables aging
+ShareClock share_clock;                   // Lottery / stride entitlements and global pass
+Predictor predictor;                      // SRTN / SJF / HRRN burst prediction, alpha 0 disables it
 
 /**
  * @brief Synchronizes the scheduler with the system clock and starts the scheduling loop.
- * @param sch_algo The scheduling algorithm to use ("rr", "hpf", or "srtn").
+ * @param sch_algo The scheduling algorithm to use ("rr", "hpf", "srtn", "edf", "rm", "lottery", "stride", "sjf" or "hrrn").
+ * @param _quantum The RR, lottery and stride quantum.
+ * @param _report_interval Ticks between rolling throughput/latency reports (0 disables them).
+ * @param _msqid The run's private message queue, created by the process generator before the fork.
+ * @param _admission What EDF does with a deadline it cannot guarantee (off, flag or reject).
+ * @param _aging_interval HPF aging: a waiting process gains one priority level every this many ticks (0 disables it).
+ * @param _predictor Burst predictor settings (alpha 0 orders on the true runtimes).
  */
-void run_scheduler(char* sch_algo, int _quantum) {
+void run_scheduler(char* sch_algo, int _quantum, int _report_interval, int _msqid, AdmissionMode _admission, int _aging_interval,
+    const Predictor* _predictor) {
     sync_clk();
-    printf(BLUE "SCHEDULER: Scheduler synchronized with clock" RESET "\n");
+    LOG_INFO(BLUE "SCHEDULER: Scheduler synchronized with clock" RESET "\n");
     quantum = _quantum;
+    report_interval = _report_interval;
+    admission = _admission;
+    aging_interval = _aging_interval;
+    predictor_init(&predictor, _predictor->alpha, _predictor->key);
 
     init_scheduler_log();
 
@@ -43,15 +63,11 @@ void run_scheduler(char* sch_algo, int _quantum) {
         exit(EXIT_FAILURE);
     }
 
-    key_t key = ftok("keyfile", 'A');
-    msqid_rcv = msgget(key, IPC_CREAT | 0666);
-    if (msqid_rcv == -1) {
-        perror(RED "msgget failed in scheduler" RESET);
-        exit(EXIT_FAILURE);
-    }
+    msqid_rcv = _msqid;
 
     signal(SIGUSR1, handle_process_termination);
     signal(SIGUSR2, handle_process_tick);
+    signal(SIGINT, handle_scheduler_interrupt);
 
     // Set selected algorithm
     set_selected_algorithm(sch_algo);
@@ -60,13 +76,15 @@ void run_scheduler(char* sch_algo, int _quantum) {
     init_queue(ready_queue, selected_algorithm);
 
     if (ready_queue == NULL) {
-        fprintf(stderr, RED "SCHEDULER: Failed to initialize ready queue" RESET "\n");
+        LOG_ERROR(RED "SCHEDULER: Failed to initialize ready queue" RESET "\n");
         exit(EXIT_FAILURE);
     }
 
     int current_time = get_clk();
-    printf(BLUE "SCHEDULER: Current time: %d, scheduler started!" RESET "\n", current_time);
+    LOG_INFO(BLUE "SCHEDULER: Current time: %d, scheduler started!" RESET "\n", current_time);
     last_process_end_time = current_time;
+    next_report_time = current_time + report_interval;
+    share_clock_init(&share_clock, current_time);
 
     // Main scheduler loop
     scheduler_loop();
@@ -97,32 +115,71 @@ void scheduler_loop() {
         // check_no_more_processes(); // removing repeated call temp
         check_no_more_processes();
 
+        if (report_interval > 0 && get_clk() >= next_report_time) {
+            rolling_report_out(get_clk(), report_interval, size(ready_queue));
+            next_report_time += report_interval;
+        }
+
         usleep(50000); // Sleep for 50ms to avoid busy-waiting
     }
 
-    scheduler_perf_out(idle_time, get_clk());
+    scheduler_perf_out(idle_time, get_clk(), &predictor);
     sleep(1);
 }
 
 /**
  * @brief Sets the scheduling algorithm based on the input string.
- * @param scheduling_algorithm The name of the scheduling algorithm ("rr", "hpf", "srtn")
+ * @param scheduling_algorithm The name of the scheduling algorithm ("rr", "hpf", "srtn", "edf", "rm", "lottery", "stride", "sjf", "hrrn")
  *          - "rr" → Round Robin
  *          - "hpf" → Highest Priority First
  *          - "srtn" → Shortest Remaining Time Next
+ *          - "edf" → Earliest Deadline First
+ *          - "rm" → Rate Monotonic
+ *          - "lottery" → Lottery scheduling
+ *          - "stride" → Stride scheduling
+ *          - "sjf" → Shortest Job First
+ *          - "hrrn" → Highest Response Ratio Next
  */
 void set_selected_algorithm(char* scheduling_algorithm) {
-    if (strcmp(scheduling_algorithm, "rr") == 0) {
-        printf(BLUE "SCHEDULER: Using Round Robin scheduling with quantum = %d" RESET "\n", quantum);
-        selected_algorithm = RR;
-    }
-    if (strcmp(scheduling_algorithm, "hpf") == 0) {
-        printf(BLUE "SCHEDULER: Using Highest Priority First scheduling" RESET "\n");
-        selected_algorithm = HPF;
+    if (parse_algorithm(scheduling_algorithm, &selected_algorithm) != 0) {
+        LOG_ERROR(RED "SCHEDULER: Unknown scheduling algorithm %s" RESET "\n", scheduling_algorithm);
+        exit(EXIT_FAILURE);
     }
-    if (strcmp(scheduling_algorithm, "srtn") == 0) {
-        printf(BLUE "SCHEDULER: Using Shortest Remaining Time Next scheduling" RESET "\n");
-        selected_algorithm = SRTN;
+
+    switch (selected_algorithm) {
+    case RR:
+        LOG_INFO(BLUE "SCHEDULER: Using Round Robin scheduling with quantum = %d" RESET "\n", quantum);
+        break;
+    case HPF:
+        if (aging_interval > 0) {
+            LOG_INFO(BLUE "SCHEDULER: Using Highest Priority First scheduling, aging one level every %d ticks" RESET "\n", aging_interval);
+        }
+        else {
+            LOG_INFO(BLUE "SCHEDULER: Using Highest Priority First scheduling" RESET "\n");
+        }
+        break;
+    case SRTN:
+        LOG_INFO(BLUE "SCHEDULER: Using Shortest Remaining Time Next scheduling" RESET "\n");
+        break;
+    case EDF:
+        LOG_INFO(BLUE "SCHEDULER: Using Earliest Deadline First scheduling, admission control %s" RESET "\n",
+            admission_name(admission));
+        break;
+    case RM:
+        LOG_INFO(BLUE "SCHEDULER: Using Rate Monotonic scheduling" RESET "\n");
+        break;
+    case LOTTERY:
+        LOG_INFO(BLUE "SCHEDULER: Using Lottery scheduling with quantum = %d" RESET "\n", quantum);
+        break;
+    case STRIDE:
+        LOG_INFO(BLUE "SCHEDULER: Using Stride scheduling with quantum = %d" RESET "\n", quantum);
+        break;
+    case SJF:
+        LOG_INFO(BLUE "SCHEDULER: Using Shortest Job First scheduling" RESET "\n");
+        break;
+    case HRRN:
+        LOG_INFO(BLUE "SCHEDULER: Using Highest Response Ratio Next scheduling" RESET "\n");
+        break;
     }
 }
 
@@ -140,52 +197,96 @@ void check_for_new_processes() {
         usleep(15000);
 
         // Read the message
-        recv_status = msgrcv(msqid_rcv, &msg, sizeof(msg.data.pcb), 1, IPC_NOWAIT);
+        recv_status = msgrcv(msqid_rcv, &msg, sizeof(msg.data.slot), 1, IPC_NOWAIT);
 
         if (recv_status == -1) {
             return;
         }
 
+        if (msg.data.slot < 0 || msg.data.slot >= PCB_TABLE_CAPACITY) {
+            LOG_ERROR(RED "SCHEDULER: Invalid PCB table slot %d received" RESET "\n", msg.data.slot);
+            return;
+        }
+
+        // The generator filled the slot before sending it: use the PCB in place
+        PCB* new_pcb = pcb_at(msg.data.slot);
+
         int current_time = get_clk();
-        printf(BLUE "SCHEDULER: Current time: %d, process %d (PID: %d) is received" RESET "\n",
-            current_time, msg.data.pcb.PDATA.id, msg.data.pcb.pid);
+        LOG_DEBUG(BLUE "SCHEDULER: Current time: %d, process %d (PID: %d) is received" RESET "\n",
+            current_time, new_pcb->PDATA.id, new_pcb->pid);
 
-        if (msg.data.pcb.pid <= 0 || msg.data.pcb.PDATA.id <= 0 || msg.data.pcb.PDATA.runtime <= 0) {
-            fprintf(stderr, RED "SCHEDULER: Invalid process data received" RESET "\n");
+        if (new_pcb->pid <= 0 || new_pcb->PDATA.id <= 0 || new_pcb->PDATA.runtime <= 0) {
+            LOG_ERROR(RED "SCHEDULER: Invalid process data received" RESET "\n");
             return;
         }
 
-        // create new pcb
-        PCB* new_pcb = malloc(sizeof(PCB));
+        // debug lines
+        LOG_TRACE("Debug: Received slot %d - Process ID: %d, Arrival Time: %d, Runtime: %d, Received PID: %d\n",
+            msg.data.slot, new_pcb->PDATA.id, new_pcb->PDATA.arrival_time, new_pcb->PDATA.runtime, new_pcb->pid);
 
-        if (new_pcb == NULL) {
-            perror(RED "SCHEDULER: Failed to allocate memory for new PCB entry" RESET);
-            exit(EXIT_FAILURE);
+        if (!admit_process(new_pcb, current_time)) {
+            continue;
         }
 
-        *new_pcb = msg.data.pcb;
-
-        printf("inside srtn");
+        if (policy_is_proportional_share(selected_algorithm)) {
+            share_clock_join(&share_clock, new_pcb, current_time);
+        }
+        if (predictor_enabled(&predictor) && policy_uses_burst(selected_algorithm)) {
+            new_pcb->predicted_runtime = predictor_estimate(&predictor, &new_pcb->PDATA);
+        }
+        enqueue(ready_queue, new_pcb, policy_queue_key(selected_algorithm, aging_interval, new_pcb));
+        LOG_DEBUG(BLUE "SCHEDULER: Process %d added to the ready queue" RESET "\n", new_pcb->PDATA.id);
+    }
+}
 
-        // debug lines
-        printf("Debug: Received message - Process ID: %d, Arrival Time: %d, Runtime: %d, Received PID: %d\n",
-            msg.data.pcb.PDATA.id, msg.data.pcb.PDATA.arrival_time, msg.data.pcb.PDATA.runtime, msg.data.pcb.pid);
+/**
+ * @brief EDF admission control of a received process
+ * @details A process whose deadline cannot be guaranteed next to the running and ready
+ *          processes is counted and either flagged (it still runs) or rejected: it is killed
+ *          before it ever runs and the generator frees its memory when it reaps it.
+ * @return int 1 if the process may be enqueued, 0 if it was rejected
+ */
+int admit_process(PCB* pcb, int current_time) {
+    if (selected_algorithm != EDF || admission == ADMISSION_OFF || pcb->PDATA.deadline <= 0) {
+        return 1;
+    }
 
-        switch (selected_algorithm) {
-        case SRTN:
-            enqueue(ready_queue, new_pcb, new_pcb->remaining_time);
-            break;
+    int count = size(ready_queue);
+    PCB** active = malloc((count + 1) * sizeof(PCB*));
+    if (active == NULL) {
+        return 1;
+    }
+    for (int i = 0; i < count; i++) {
+        active[i] = (PCB*)queue_at(ready_queue, i);
+    }
+    // EDF keeps the running process in the ready queue, count it once
+    int running_queued = 0;
+    for (int i = 0; i < count; i++) {
+        running_queued |= active[i] == current_pcb;
+    }
+    if (current_pcb != NULL && !running_queued) {
+        active[count++] = current_pcb;
+    }
 
-        case HPF:
-            enqueue(ready_queue, new_pcb, new_pcb->PDATA.priority);
-            break;
+    int feasible = policy_deadline_feasible(current_time, pcb, active, count);
+    free(active);
+    if (feasible) {
+        return 1;
+    }
 
-        case RR:
-            enqueue(ready_queue, new_pcb, 0); // RR doesn't use priority
-            break;
-        }
-        printf(BLUE "SCHEDULER: Process %d added to the ready queue" RESET "\n", new_pcb->PDATA.id);
+    if (admission == ADMISSION_FLAG) {
+        LOG_DEBUG(YELLOW "SCHEDULER: Process %d may miss its deadline %d" RESET "\n", pcb->PDATA.id, pcb->PDATA.deadline);
+        record_admission(0);
+        return 1;
     }
+
+    LOG_DEBUG(YELLOW "SCHEDULER: Process %d rejected, deadline %d cannot be met" RESET "\n", pcb->PDATA.id, pcb->PDATA.deadline);
+    record_admission(1);
+    pcb->state = "rejected";
+    log_event(pcb);
+    kill(pcb->pid, SIGKILL);
+    pcb_table_release(pcb_slot(pcb), PCB_SLOT_SCHEDULER);
+    return 0;
 }
 
 /**
@@ -194,6 +295,8 @@ void check_for_new_processes() {
 void handle_current_running_process() {
     switch (selected_algorithm) {
     case RR:
+    case LOTTERY:
+    case STRIDE:
         if (current_pcb != NULL && current_pcb->remaining_time <= last_remain_time - quantum) {
             current_pcb->remaining_time = last_remain_time - quantum;
             handle_quantum_expiration(0);
@@ -201,12 +304,16 @@ void handle_current_running_process() {
         break;
 
     case HPF:
+    case SJF:
+    case HRRN:
         if (current_pcb == NULL) {
             schedule_next_process();
         }
         break;
 
     case SRTN:
+    case EDF:
+    case RM:
         // Process* next_process = (Process*)front(ready_queue);
         // Process* next_process = &next_pcb->process;
         PCB* next_pcb = (PCB*)front(ready_queue);
@@ -219,11 +326,12 @@ void handle_current_running_process() {
 
         if (next_pcb != NULL && current_pcb != NULL && next_pcb != current_pcb) {
 
-            printf(GREEN "SCHEDULER: Next process in queue: %d (PID: %d) TR: %d, current process TR: %d queue size: %d" RESET "\n",
+            LOG_TRACE(GREEN "SCHEDULER: Next process in queue: %d (PID: %d) TR: %d, current process TR: %d queue size: %d" RESET "\n",
                 next_id, next_pid, next_pcb->remaining_time, current_pcb->remaining_time, size(ready_queue));
 
-            printf(BLUE "SCHEDULER: Process %d (PID: %d) has a shorter remaining time than current process %d (PID: %d) (%d < %d)" RESET "\n",
-                next_id, next_pid, current_pcb->PDATA.id, current_pcb->pid, next_pcb->remaining_time, current_pcb->remaining_time);
+            LOG_DEBUG(BLUE "SCHEDULER: Process %d (PID: %d) preempts current process %d (PID: %d) (%lld < %lld)" RESET "\n",
+                next_id, next_pid, current_pcb->PDATA.id, current_pcb->pid,
+                policy_priority(selected_algorithm, next_pcb), policy_priority(selected_algorithm, current_pcb));
 
             handle_quantum_expiration(0);
         }
@@ -240,8 +348,9 @@ void schedule_next_process() {
         return;
     }
 
-    if (selected_algorithm == HPF) {
+    if (policy_runs_to_completion(selected_algorithm)) {
         // current_running_process = (Process*)dequeue(ready_queue, 1); // remove entirly from ready queue
+        queue_advance(ready_queue, get_clk());
         current_pcb = (PCB*)dequeue(ready_queue, 1);
     }
     else {
@@ -249,7 +358,7 @@ void schedule_next_process() {
         current_pcb = (PCB*)front(ready_queue);
     }
 
-    printf(BLUE "SCHEDULER: Scheduling process %d (PID: %d) with remaining time %d" RESET "\n",
+    LOG_DEBUG(BLUE "SCHEDULER: Scheduling process %d (PID: %d) with remaining time %d" RESET "\n",
         current_pcb->PDATA.id, current_pcb->pid, current_pcb->remaining_time);
 
     if (current_pcb == NULL) {
@@ -257,7 +366,7 @@ void schedule_next_process() {
     }
 
     int current_time = get_clk();
-    printf(BLUE "SCHEDULER: Current time: %d, running process %d (PID: %d)" RESET "\n",
+    LOG_DEBUG(BLUE "SCHEDULER: Current time: %d, running process %d (PID: %d)" RESET "\n",
         current_time, current_pcb->PDATA.id, current_pcb->pid);
 
     if (current_pcb->start_time == -1) {
@@ -271,6 +380,8 @@ void schedule_next_process() {
             (current_time - current_pcb->PDATA.arrival_time) - (current_pcb->PDATA.runtime - current_pcb->remaining_time);
     }
 
+    share_clock_dispatch(&share_clock, current_pcb);
+
     // Start or resume the process
     kill(current_pcb->pid, SIGCONT);
     last_remain_time = current_pcb->remaining_time;
@@ -279,8 +390,8 @@ void schedule_next_process() {
 
     log_event(current_pcb);
 
-    if (selected_algorithm == RR) {
-        printf(BLUE "SCHEDULER: Quantum will expire at time %d" RESET "\n", current_time + quantum);
+    if (policy_uses_quantum(selected_algorithm)) {
+        LOG_TRACE(BLUE "SCHEDULER: Quantum will expire at time %d" RESET "\n", current_time + quantum);
     }
 }
 
@@ -292,7 +403,7 @@ void schedule_next_process() {
 void handle_process_termination(int signum) {
     int current_time = get_clk();
 
-    printf(GREEN "SCHEDULER: Process %d (PID: %d) has completed execution at time %d" RESET "\n",
+    LOG_DEBUG(GREEN "SCHEDULER: Process %d (PID: %d) has completed execution at time %d" RESET "\n",
         current_pcb->PDATA.id, current_pcb->pid, current_time);
 
     fprintf(execution_log, "P%d (burst %d) runs %d → %d and finishes at %d\n\n",
@@ -305,21 +416,29 @@ void handle_process_termination(int signum) {
 
     last_process_end_time = current_time;
 
-    if (selected_algorithm != HPF) {
+    if (!policy_runs_to_completion(selected_algorithm)) {
         dequeue(ready_queue, 1);
     }
 
     if (!is_empty(ready_queue)) {
-        printf("SCHEDULER: Context Switching to next process with id %d\n", ((Process*)front(ready_queue))->id);
+        LOG_DEBUG("SCHEDULER: Context Switching to next process with id %d\n", ((Process*)front(ready_queue))->id);
     }
     else {
-        printf(BLUE "SCHEDULER: No more processes in the queue" RESET "\n");
+        LOG_DEBUG(BLUE "SCHEDULER: No more processes in the queue" RESET "\n");
     }
 
     current_pcb->remaining_time--;
     current_pcb->state = "finished";
+    if (policy_is_proportional_share(selected_algorithm)) {
+        share_clock_leave(&share_clock, current_pcb, current_time);
+    }
+    if (current_pcb->predicted_runtime > 0) {
+        predictor_observe(&predictor, &current_pcb->PDATA, current_pcb->predicted_runtime);
+    }
     log_event(current_pcb);
 
+    // The scheduler is done with the PCB, the generator may reuse the slot once the process is reaped
+    pcb_table_release(pcb_slot(current_pcb), PCB_SLOT_SCHEDULER);
     current_pcb = NULL;
     last_remain_time = 0; // Reset last start time
 
@@ -337,7 +456,7 @@ void handle_quantum_expiration(int signum) {
         return;
     }
     int current_time = get_clk();
-    printf(BLUE "SCHEDULER: Quantum expired for process %d at time %d" RESET "\n",
+    LOG_DEBUG(BLUE "SCHEDULER: Quantum expired for process %d at time %d" RESET "\n",
         current_pcb->PDATA.id, current_time);
 
     fprintf(execution_log, "P%d (burst %d) runs %d → %d (rem %d)\n\n",
@@ -354,13 +473,19 @@ void handle_quantum_expiration(int signum) {
 
     current_pcb->state = "stopped";
     log_event(current_pcb);
+    policy_charge(selected_algorithm, current_pcb, last_remain_time - current_pcb->remaining_time);
+
+    if (selected_algorithm == RR || selected_algorithm == LOTTERY) {
+        dequeue(ready_queue, 0); // RR moves on to the next process, lottery holds a new draw
+    }
+    else if (selected_algorithm == STRIDE) {
+        // The stopped process is still the heap root: re-key it with its charged pass
+        change_priority(ready_queue, 0, current_pcb->pass);
+    }
 
     current_pcb = NULL;
     usleep(1000); // Sleep for 1ms to ensure the process is stopped
 
-    if (selected_algorithm == RR)
-        dequeue(ready_queue, 0);
-
     // Reset quantum tracking variables
     log_start_time = 0;
     // Reset current process
@@ -372,25 +497,25 @@ void handle_quantum_expiration(int signum) {
  * @details This function decrements the remaining time of the current process.
  */
 void handle_process_tick(int signum) {
-    printf(BLUE "SCHEDULER: Tick received for process %d (PID: %d)" RESET "\n",
-        current_pcb->PDATA.id, current_pcb->pid);
-
     if (current_pcb == NULL) {
         return;
     }
 
+    LOG_TRACE(BLUE "SCHEDULER: Tick received for process %d (PID: %d)" RESET "\n",
+        current_pcb->PDATA.id, current_pcb->pid);
+
     int current_time = get_clk();
     current_pcb->remaining_time--;
 
     switch (selected_algorithm) {
     case SRTN:
-        change_priority(ready_queue, 0, current_pcb->remaining_time);
+        change_priority(ready_queue, 0, policy_priority(selected_algorithm, current_pcb));
         break;
     default:
         break;
     }
 
-    printf("SCHEDULER: Process %d (PID: %d) ticked at time %d, remaining time: %d\n",
+    LOG_TRACE("SCHEDULER: Process %d (PID: %d) ticked at time %d, remaining time: %d\n",
         current_pcb->PDATA.id, current_pcb->pid, current_time, current_pcb->remaining_time);
 }
 
@@ -413,4 +538,19 @@ void check_no_more_processes() {
     if (strcmp(msg.data.str, "no_more_processes") == 0) {
         no_more_processes = 1;
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Handle SIGINT (open-loop runs end this way)
+ * @param signum The signal number (expected to be SIGINT).
+ * @details Writes scheduler.perf for everything finished so far, then exits.
+ */
+void handle_scheduler_interrupt(int signum) {
+    (void)signum;
+    int current_time = get_clk();
+    if (current_pcb == NULL && current_time > last_process_end_time) {
+        idle_time += current_time - last_process_end_time;
+    }
+    scheduler_perf_out(idle_time, current_time, &predictor);
+    exit(EXIT_SUCCESS);
+}
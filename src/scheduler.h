@@ -7,6 +7,9 @@
 #include "clk.h"
 #include "process.h"
 #include "PCB.h"
+#include "pcb_table.h"
+#include "predictor.h"
+#include "Algorithms/utils.h"
 
 // Color Macros
 #define RED "\x1b[31m"
@@ -17,23 +20,24 @@
 #define CYAN "\x1b[36m"
 #define RESET "\x1b[0m"
 
-// Buffer struct for sending/receiving process structs
+// Buffer struct for sending/receiving arrivals (PCB table slots) and control messages
 typedef struct msgbuf
 {
     long mtype;
     union
     {
-        // Process proc;           // Process structure
-        PCB pcb;
+        int slot;     // PCB table slot of an arriving process
         char str[18]; // String message
     } data;
 } msg_struct;
 
-void run_scheduler(char* sch_algo, int _quantum); // Starts the schedular
+void run_scheduler(char* sch_algo, int _quantum, int _report_interval, int _msqid, AdmissionMode _admission, int _aging_interval,
+    const Predictor* _predictor); // Starts the schedular
 void scheduler_loop(); // Main scheduler loop
 
 void set_selected_algorithm(char* scheduling_algorithm); // Function to select the algorithm
 void check_for_new_processes(); // Check for new processes in the  ready queue
+int admit_process(PCB* pcb, int current_time); // EDF deadline admission control of a received process
 void handle_current_running_process(); // Handle the currently running process based on selected algo
 void schedule_next_process(); // Schedules the next process
 
@@ -42,5 +46,6 @@ void handle_process_termination(int signum); // Handle process termination
 void handle_quantum_expiration(int signum);  // Handle quantum expiration
 void handle_process_tick(int signum);        // Handle process tick
 void check_no_more_processes();              // Check for no_more_processes message
+void handle_scheduler_interrupt(int signum); // Write scheduler.perf before exiting on SIGINT
 
 #endif
\ No newline at end of file
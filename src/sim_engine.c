@@ -0,0 +1,1895 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_engine.h"
+#include "PCB.h"
+#include "buddy_memory.h"
+#include "memory_manager.h"
+#include "file_handlers.h"
+#include "logger.h"
+#include "DS/IQueue.h"
+#include "Algorithms/policy.h"
+
+#define SIM_WORK_EPSILON 1e-9 // rounding slack of work = ticks * speed
+
+typedef enum EventType {
+    EVENT_ARRIVAL, // a submitted process arrives
+    EVENT_RUN_END, // a CPU's process finishes, its quantum expires or it issues an I/O request
+    EVENT_IO_END,  // a device finished serving its current request
+    EVENT_PERIOD,  // a throttled task group's next quota period starts
+    EVENT_SWAP_END // the swap device finished its current transfer
+} EventType;
+
+typedef struct Event {
+    int time;
+    EventType type;
+    long long seq;           // submission order, breaks ties deterministically
+    Process* proc;           // arrival data (EVENT_ARRIVAL)
+    unsigned int generation; // dispatch the event belongs to (EVENT_RUN_END)
+    int index;               // CPU (EVENT_RUN_END), device (EVENT_IO_END) or task group (EVENT_PERIOD) index
+} Event;
+
+// A simulated device: one request in service, the others queued in FIFO order,
+// or by cylinder for a disk with a policy other than FCFS
+typedef struct SimDevice {
+    IoDevice model;  // service time or disk model, copied from the configuration
+    IQueue queue;    // blocked processes waiting for the device (PCB*)
+    DiskQueue* disk; // blocked processes waiting for the disk by cylinder, NULL for FIFO devices
+    DiskHead head;
+    PCB* serving;
+} SimDevice;
+
+// A simulated CPU and the run in progress on it
+typedef struct SimCpu {
+    double speed;            // work units per tick
+    PCB* running;
+    int run_start;           // start of the current run (execution log)
+    int run_end;             // planned end of the current run
+    int accounted_until;     // running->remaining_time is exact up to this time
+    int target;              // work units the run does if it is not interrupted
+    int work_done;           // work units of the run taken off remaining_time so far
+    double carry;            // running->work_carry when the run started
+    unsigned int generation; // bumped on every dispatch / preemption
+    int last_run_id;         // process that ran last, -1 before the first dispatch
+    int last_end_time;       // end of the last run, idle gaps start there
+    int dispatched_at;       // time of the last dispatch
+    int node;                // memory node the CPU belongs to
+    double rate;             // work units per tick of the current run, the speed slowed by remote memory
+} SimCpu;
+
+// A memory node: its buddy allocator and the state of its fragmentation statistics
+typedef struct SimNode {
+    Block* memory;
+    int first_cpu;   // CPUs first_cpu .. first_cpu + cpu_count - 1 are local to the node
+    int cpu_count;
+    int used;        // bytes in allocated blocks
+    int internal;    // bytes allocated blocks hold beyond their requests
+    double external; // external fragmentation since changed_at
+    int changed_at;  // the statistics integrals are exact up to this time
+} SimNode;
+
+// A task group: its ready processes in policy order, fair share and quota state
+typedef struct SimGroup {
+    TaskGroup model;  // shares and quota, copied from the configuration
+    IQueue queue;     // ready processes of the group (PCB*)
+    double vtime;     // CPU time received divided by the group's shares
+    int period_start; // start of the current quota period
+    int used;         // CPU ticks used in the current period
+    int throttled;    // quota spent, waiting for the next period
+    int throttled_at;
+} SimGroup;
+
+struct Sim {
+    SimConfig config;
+    SimStats stats;
+
+    // Event queue (binary min-heap on time, then seq)
+    Event* events;
+    int event_count;
+    int event_capacity;
+    long long next_seq;
+    int failed; // a step could not allocate memory, the simulation stopped
+
+    // Arrivals of the current time step
+    Process** arrivals;
+    int arrival_count;
+    int arrival_capacity;
+
+    SimGroup* groups; // group 0 alone without groups
+    int group_count;
+    int group_slice;  // with several groups, the longest run before the fair share picks again
+    double min_vtime; // virtual time of the last group picked, never decreases
+    SimCpu cpus[SIM_MAX_CPUS]; // the first cpu_count are in use
+    int cpu_count;
+    int running_count; // CPUs running a process
+
+    SimNode nodes[SIM_MAX_NODES]; // the first node_count are in use, one without NUMA
+    int node_count;
+    int next_node; // interleave: node of the next allocation
+    OrderQueue* waiting; // processes waiting for memory by buddy order (Process*)
+    int memory_held;     // aging: a process that waited too long holds the freed memory
+    int memory_used;     // bytes in allocated blocks over all nodes
+
+    // Swapping, with a swap device only
+    PCB** admitted;      // processes that got memory and have not finished, in memory or swapped out
+    int admitted_count;
+    int admitted_capacity;
+    IQueue swap_queue;   // transfers waiting for the swap device (PCB*)
+    PCB* swapping;       // transfer in progress, NULL when the device is idle
+    int swap_outs_pending; // swap-outs queued or in progress
+    PCB* swap_wanted;    // swapped-out process due to run that found no memory, holds the freed memory
+
+    ShareClock share_clock; // lottery / stride entitlements and global pass
+
+    int pending_overhead; // allocation cost not paid by a dispatch yet
+
+    SimDevice devices[IO_MAX_DEVICES]; // the first device_count are in use
+    int device_count;
+    int busy_devices;        // devices serving a request
+    int io_accounted_until;  // I/O busy and overlap time are exact up to this time
+    Rng rng;                 // service times drawn from the device models
+    PCB** woken;             // processes whose I/O completed in the current time step
+    int woken_count;
+    int woken_capacity;
+    PCB** passed;            // ready processes passed over by a dispatch for their affinity
+    int passed_capacity;
+};
+
+/**
+ * @brief Default configuration: HPF, quantum 1, MAX_SIZE memory, no logs
+ */
+void sim_config_init(SimConfig* config) {
+    memset(config, 0, sizeof(SimConfig));
+    config->algorithm = HPF;
+    config->quantum = 1;
+    config->memory_size = MAX_SIZE;
+    config->admission = ADMISSION_FLAG;
+    config->seed = 1;
+    config->cpu_count = 1;
+    config->cpu_speed[0] = 1;
+    config->numa.nodes = 1;
+    config->numa.policy = NUMA_LOCAL;
+    config->numa.remote_penalty = 1.5;
+    config->admit.policy = ADMIT_OLDEST;
+    config->admit.age = 100;
+}
+
+/**
+ * @brief Map an allocator name ("buddy", "none") to its enum value
+ *
+ * @return int 0 for success, 1 for an unknown name
+ */
+int parse_allocator(const char* name, SimAllocator* allocator) {
+    if (strcmp(name, "buddy") == 0) {
+        *allocator = SIM_ALLOC_BUDDY;
+    }
+    else if (strcmp(name, "none") == 0) {
+        *allocator = SIM_ALLOC_NONE;
+    }
+    else {
+        return 1;
+    }
+    return 0;
+}
+
+const char* allocator_name(SimAllocator allocator) {
+    return allocator == SIM_ALLOC_NONE ? "none" : "buddy";
+}
+
+/**
+ * @brief Parse an overhead cost list such as "switch=1,dispatch=2,migrate=3,alloc=1"
+ * @details Costs are non-negative ticks; costs left out stay as they are.
+ *
+ * @return int 0 for success, 1 for an unknown name or an invalid value
+ */
+int parse_costs(const char* spec, SimCosts* costs) {
+    char* copy = strdup(spec);
+    if (copy == NULL) {
+        return 1;
+    }
+
+    int status = 0;
+    char* save = NULL;
+    for (char* item = strtok_r(copy, ",", &save); item != NULL && status == 0; item = strtok_r(NULL, ",", &save)) {
+        char* value = strchr(item, '=');
+        if (value == NULL) {
+            status = 1;
+            break;
+        }
+        *value++ = '\0';
+
+        char* end;
+        long ticks = strtol(value, &end, 10);
+        if (*value == '\0' || *end != '\0' || ticks < 0 || ticks > INT_MAX) {
+            status = 1;
+        }
+        else if (strcmp(item, "switch") == 0) {
+            costs->context_switch = (int)ticks;
+        }
+        else if (strcmp(item, "dispatch") == 0) {
+            costs->first_dispatch = (int)ticks;
+        }
+        else if (strcmp(item, "migrate") == 0) {
+            costs->migration = (int)ticks;
+        }
+        else if (strcmp(item, "alloc") == 0) {
+            costs->allocation = (int)ticks;
+        }
+        else {
+            status = 1;
+        }
+    }
+
+    free(copy);
+    return status;
+}
+
+/**
+ * @brief Parse a CPU list such as "2x1.5,4", <count>[x<speed>] per kind of core
+ * @details Two CPUs of speed 1.5 then four of speed 1 (the default speed).
+ *
+ * @return int 0 for success, 1 for an invalid count or speed or more than SIM_MAX_CPUS CPUs
+ */
+int parse_cpus(const char* spec, SimConfig* config) {
+    char* copy = strdup(spec);
+    if (copy == NULL) {
+        return 1;
+    }
+
+    int count = 0;
+    int status = 0;
+    char* save = NULL;
+    for (char* item = strtok_r(copy, ",", &save); item != NULL && status == 0; item = strtok_r(NULL, ",", &save)) {
+        char* end;
+        long cpus = strtol(item, &end, 10);
+        double speed = 1;
+        if (*end == 'x') {
+            char* speed_str = end + 1;
+            speed = strtod(speed_str, &end);
+            if (*speed_str == '\0') {
+                status = 1;
+            }
+        }
+        if (end == item || *end != '\0' || cpus <= 0 || cpus > SIM_MAX_CPUS - count || !(speed > 0 && speed <= 1000)) {
+            status = 1;
+            break;
+        }
+        for (int i = 0; i < cpus; i++) {
+            config->cpu_speed[count++] = speed;
+        }
+    }
+
+    free(copy);
+    if (status == 0 && count > 0) {
+        config->cpu_count = count;
+        return 0;
+    }
+    return 1;
+}
+
+static const char* numa_policy_names[] = { "local", "strict", "interleave" };
+
+const char* numa_policy_name(NumaPolicy policy) {
+    return numa_policy_names[policy];
+}
+
+/**
+ * @brief Parse a NUMA layout such as "2,policy=strict,remote=2"
+ * @details The node count, then optional settings; settings left out stay as they are.
+ *
+ * @return int 0 for success, 1 for an invalid node count, an unknown setting or an invalid value
+ */
+int parse_numa(const char* spec, SimNuma* numa) {
+    char* copy = strdup(spec);
+    if (copy == NULL) {
+        return 1;
+    }
+
+    char* save = NULL;
+    char* item = strtok_r(copy, ",", &save);
+    char* end;
+    long nodes = item != NULL ? strtol(item, &end, 10) : 0;
+    int status = item == NULL || *end != '\0' || nodes <= 0 || nodes > SIM_MAX_NODES;
+    if (status == 0) {
+        numa->nodes = (int)nodes;
+    }
+
+    for (item = strtok_r(NULL, ",", &save); item != NULL && status == 0; item = strtok_r(NULL, ",", &save)) {
+        char* value = strchr(item, '=');
+        if (value == NULL) {
+            status = 1;
+            break;
+        }
+        *value++ = '\0';
+
+        if (strcmp(item, "policy") == 0) {
+            status = 1;
+            for (int i = 0; i < (int)(sizeof(numa_policy_names) / sizeof(numa_policy_names[0])); i++) {
+                if (strcmp(value, numa_policy_names[i]) == 0) {
+                    numa->policy = (NumaPolicy)i;
+                    status = 0;
+                }
+            }
+        }
+        else if (strcmp(item, "remote") == 0) {
+            double penalty = strtod(value, &end);
+            if (*value == '\0' || *end != '\0' || !(penalty >= 1 && penalty <= 100)) {
+                status = 1;
+            }
+            else {
+                numa->remote_penalty = penalty;
+            }
+        }
+        else {
+            status = 1;
+        }
+    }
+
+    free(copy);
+    return status;
+}
+
+/**
+ * @brief Parse a swap device such as "64,latency=5": bytes moved per tick, then the fixed
+ *        ticks of every transfer (1 when left out)
+ *
+ * @return int 0 for success, 1 for an invalid bandwidth, an unknown setting or an invalid value
+ */
+int parse_swap(const char* spec, SimSwap* swap) {
+    char* copy = strdup(spec);
+    if (copy == NULL) {
+        return 1;
+    }
+
+    char* save = NULL;
+    char* item = strtok_r(copy, ",", &save);
+    char* end;
+    long bandwidth = item != NULL ? strtol(item, &end, 10) : 0;
+    int status = item == NULL || *end != '\0' || bandwidth <= 0 || bandwidth > INT_MAX;
+    if (status == 0) {
+        swap->bandwidth = (int)bandwidth;
+        swap->latency = 1;
+    }
+
+    for (item = strtok_r(NULL, ",", &save); item != NULL && status == 0; item = strtok_r(NULL, ",", &save)) {
+        long latency = strncmp(item, "latency=", 8) == 0 ? strtol(item + 8, &end, 10) : -1;
+        if (latency < 0 || latency > WORKLOAD_MAX_RUNTIME || item[8] == '\0' || *end != '\0') {
+            status = 1;
+            break;
+        }
+        swap->latency = (int)latency;
+    }
+
+    free(copy);
+    return status;
+}
+
+/**
+ * @brief Create a simulation
+ *
+ * @return Sim* the simulation, NULL on invalid configuration or allocation failure
+ */
+Sim* sim_create(const SimConfig* config) {
+    if (config->quantum <= 0 || config->memory_size <= 0 || (config->memory_size & (config->memory_size - 1)) != 0 ||
+        config->cpu_count <= 0 || config->cpu_count > SIM_MAX_CPUS ||
+        config->numa.nodes <= 0 || config->numa.nodes > config->cpu_count || config->numa.remote_penalty < 1 ||
+        (config->admit.policy == ADMIT_AGING && config->admit.age < 1) ||
+        config->swap.bandwidth < 0 || config->swap.latency < 0 ||
+        config->io_device_count < 0 || config->io_device_count > IO_MAX_DEVICES ||
+        (config->io_device_count > 0 && config->io_devices == NULL) ||
+        config->task_group_count < 0 || (config->task_group_count > 0 && config->task_groups == NULL)) {
+        return NULL;
+    }
+
+    Sim* sim = calloc(1, sizeof(Sim));
+    if (sim == NULL) {
+        return NULL;
+    }
+
+    sim->config = *config;
+    perf_stats_init(&sim->stats.perf);
+    job_table_init(&sim->stats.jobs);
+    share_clock_init(&sim->share_clock, 0);
+    sim->cpu_count = config->cpu_count;
+    sim->stats.cpu_count = config->cpu_count;
+    for (int i = 0; i < sim->cpu_count; i++) {
+        sim->cpus[i].speed = config->cpu_speed[i];
+        sim->stats.cpu[i].speed = config->cpu_speed[i];
+        sim->cpus[i].last_run_id = -1;
+    }
+    predictor_init(&sim->stats.predictor, policy_uses_burst(config->algorithm) ? config->predict_alpha : 0,
+        config->predict_key);
+    io_stats_init(&sim->stats.io);
+    memory_stats_init(&sim->stats.memory);
+    running_stat_init(&sim->stats.swap.out_time);
+    running_stat_init(&sim->stats.swap.ta_swapped);
+    running_stat_init(&sim->stats.swap.ta_resident);
+    rng_seed(&sim->rng, config->seed);
+    sim->device_count = config->io_device_count;
+    for (int i = 0; i < sim->device_count; i++) {
+        sim->devices[i].model = config->io_devices[i];
+        init_queue(&sim->devices[i].queue, RR);
+        if (sim->devices[i].model.is_disk && sim->devices[i].model.disk.policy != DISK_FCFS) {
+            sim->devices[i].disk = disk_queue(sim->devices[i].model.disk.cylinders);
+        }
+        sim->devices[i].head.direction = 1;
+    }
+
+    sim->event_capacity = 64;
+    sim->events = malloc(sim->event_capacity * sizeof(Event));
+    sim->arrival_capacity = 16;
+    sim->arrivals = malloc(sim->arrival_capacity * sizeof(Process*));
+    sim->woken_capacity = 16;
+    sim->woken = malloc(sim->woken_capacity * sizeof(PCB*));
+    sim->passed_capacity = 16;
+    sim->passed = malloc(sim->passed_capacity * sizeof(PCB*));
+
+    static const TaskGroup default_group = { "default", 1, 0, 0 };
+    int group_count = config->task_group_count > 0 ? config->task_group_count : 1;
+    sim->groups = calloc(group_count, sizeof(SimGroup));
+    sim->stats.groups = calloc(group_count, sizeof(TaskGroupStats));
+    if (sim->groups != NULL && sim->stats.groups != NULL) {
+        sim->group_count = group_count;
+        sim->stats.group_count = group_count;
+    }
+    for (int i = 0; i < sim->group_count; i++) {
+        sim->groups[i].model = config->task_group_count > 0 ? config->task_groups[i] : default_group;
+        init_queue(&sim->groups[i].queue, config->algorithm);
+        task_group_stats_init(&sim->stats.groups[i]);
+    }
+    if (sim->group_count > 1 && !policy_runs_to_completion(config->algorithm)) {
+        sim->group_slice = config->quantum;
+    }
+    // Node k holds addresses k * memory_size onwards and an equal share of the CPUs
+    sim->node_count = config->numa.nodes;
+    sim->stats.node_count = config->numa.nodes;
+    int status = 0;
+    for (int i = 0; i < sim->node_count; i++) {
+        SimNode* node = &sim->nodes[i];
+        node->memory = init_memory_size(config->memory_size);
+        if (node->memory == NULL) {
+            status = 1;
+            continue;
+        }
+        node->memory->start = i * config->memory_size;
+        node->first_cpu = i * sim->cpu_count / sim->node_count;
+        node->cpu_count = (i + 1) * sim->cpu_count / sim->node_count - node->first_cpu;
+        for (int cpu = node->first_cpu; cpu < node->first_cpu + node->cpu_count; cpu++) {
+            sim->cpus[cpu].node = i;
+        }
+        sim->stats.node[i].memory_size = config->memory_size;
+        sim->stats.node[i].cpu_count = node->cpu_count;
+    }
+    sim->waiting = order_queue();
+    if (config->swap.bandwidth > 0) {
+        sim->admitted_capacity = 16;
+        sim->admitted = malloc(sim->admitted_capacity * sizeof(PCB*));
+        init_queue(&sim->swap_queue, RR);
+        status |= sim->admitted == NULL;
+    }
+
+    if (sim->events == NULL || sim->arrivals == NULL || sim->woken == NULL || sim->passed == NULL ||
+        sim->group_count == 0 || status != 0 || sim->waiting == NULL) {
+        sim_destroy(sim);
+        return NULL;
+    }
+
+    return sim;
+}
+
+/**
+ * @brief Log a failed allocation during a step and stop the simulation
+ */
+static void sim_fail(Sim* sim, const char* what) {
+    LOG_ERROR("Error: Failed to allocate memory for %s.\n", what);
+    sim->failed = 1;
+}
+
+static int event_before(const Event* a, const Event* b) {
+    return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
+static int event_push(Sim* sim, Event event) {
+    if (sim->event_count == sim->event_capacity) {
+        Event* events = realloc(sim->events, 2 * sim->event_capacity * sizeof(Event));
+        if (events == NULL) {
+            return 1;
+        }
+        sim->events = events;
+        sim->event_capacity *= 2;
+    }
+
+    event.seq = sim->next_seq++;
+
+    int i = sim->event_count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!event_before(&event, &sim->events[parent])) {
+            break;
+        }
+        sim->events[i] = sim->events[parent];
+        i = parent;
+    }
+    sim->events[i] = event;
+    return 0;
+}
+
+static Event event_pop(Sim* sim) {
+    Event top = sim->events[0];
+    Event last = sim->events[--sim->event_count];
+
+    int i = 0;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= sim->event_count) {
+            break;
+        }
+        if (child + 1 < sim->event_count && event_before(&sim->events[child + 1], &sim->events[child])) {
+            child++;
+        }
+        if (!event_before(&sim->events[child], &last)) {
+            break;
+        }
+        sim->events[i] = sim->events[child];
+        i = child;
+    }
+    if (sim->event_count > 0) {
+        sim->events[i] = last;
+    }
+    return top;
+}
+
+/**
+ * @brief Submit a process, it arrives at proc->arrival_time
+ *
+ * @return int 0 for success, 1 for invalid process data, an affinity without any of the
+ *         simulated CPUs or an arrival in the simulated past
+ */
+int sim_submit(Sim* sim, const Process* proc) {
+    unsigned int cpus = (1u << sim->cpu_count) - 1;
+    if (proc->runtime <= 0 || proc->memory_size <= 0 || proc->arrival_time < sim->stats.current_time ||
+        (sim->config.allocator == SIM_ALLOC_BUDDY && proc->memory_size > sim->config.memory_size) ||
+        (proc->affinity != 0 && (proc->affinity & cpus) == 0)) {
+        return 1;
+    }
+    if (proc->group < 0 || proc->group >= sim->group_count) {
+        return 1;
+    }
+    for (int i = 0; i < proc->io_count; i++) {
+        if (proc->io[i].device >= sim->device_count) {
+            return 1;
+        }
+    }
+
+    Process* copy = malloc(sizeof(Process));
+    if (copy == NULL) {
+        return 1;
+    }
+    *copy = *proc;
+
+    Event event = { proc->arrival_time, EVENT_ARRIVAL, 0, copy, 0, 0 };
+    if (event_push(sim, event) != 0) {
+        free(copy);
+        return 1;
+    }
+
+    sim->stats.submitted++;
+    return 0;
+}
+
+/**
+ * @brief Work units per tick of the process on the CPU: its speed, divided by the remote
+ *        penalty when the process's memory is on another node
+ */
+static double sim_rate(Sim* sim, const SimCpu* cpu, const PCB* pcb) {
+    if (pcb->node >= 0 && pcb->node != cpu->node) {
+        return cpu->speed / sim->config.numa.remote_penalty;
+    }
+    return cpu->speed;
+}
+
+/**
+ * @brief Bring the remaining time of the CPU's process and the busy time up to `time`
+ * @details Nothing ran before accounted_until, the CPU is still paying the dispatch overhead.
+ *          A CPU of speed s does s work units per tick, the fraction of a unit done when
+ *          the run is interrupted carries over to the process's next run.
+ */
+static void sim_account_running(Sim* sim, SimCpu* cpu, int time) {
+    if (time < cpu->accounted_until) {
+        return;
+    }
+
+    int ran = time - cpu->accounted_until;
+    double work = cpu->carry + (time - cpu->run_start) * cpu->rate + SIM_WORK_EPSILON;
+    int done = work >= cpu->target ? cpu->target : (int)work;
+    cpu->running->remaining_time -= done - cpu->work_done;
+    cpu->running->work_carry = done == cpu->target ? 0 : work - SIM_WORK_EPSILON - done;
+
+    SimCpuStats* stats = &sim->stats.cpu[cpu - sim->cpus];
+    stats->busy_time += ran;
+    stats->work += done - cpu->work_done;
+    sim->stats.busy_time += ran;
+    if (cpu->running->node >= 0) {
+        SimNodeStats* node = &sim->stats.node[cpu->running->node];
+        if (cpu->running->node == cpu->node) {
+            node->local_time += ran;
+        }
+        else {
+            node->remote_time += ran;
+        }
+    }
+    cpu->work_done = done;
+    cpu->accounted_until = time;
+}
+
+static void sim_log_event(Sim* sim, PCB* pcb, int time) {
+    if (sim->config.scheduler_log != NULL) {
+        write_event(sim->config.scheduler_log, pcb, time);
+    }
+}
+
+/**
+ * @brief Make a process ready in its task group
+ * @details A group that had nothing ready catches up to the virtual time of the other
+ *          groups, it does not get the CPU time it missed while idle back.
+ */
+static void sim_enqueue(Sim* sim, PCB* pcb) {
+    SimGroup* group = &sim->groups[pcb->PDATA.group];
+    if (is_empty(&group->queue) && group->vtime < sim->min_vtime) {
+        group->vtime = sim->min_vtime;
+    }
+    enqueue(&group->queue, pcb, policy_queue_key(sim->config.algorithm, sim->config.aging_interval, pcb));
+}
+
+static int sim_ready_count(Sim* sim) {
+    int count = 0;
+    for (int i = 0; i < sim->group_count; i++) {
+        count += size(&sim->groups[i].queue);
+    }
+    return count;
+}
+
+/**
+ * @brief Start a new quota period when the current one is over at `time`
+ */
+static void sim_group_refresh(SimGroup* group, const TaskGroup* model, int time) {
+    if (model->quota > 0 && time >= group->period_start + model->period) {
+        group->period_start = time - time % model->period;
+        group->used = 0;
+    }
+}
+
+/**
+ * @brief Charge the ticks the CPU's process ran since run_start to its task group
+ * @details A group that spent its quota is throttled until its next period.
+ */
+static void sim_group_charge(Sim* sim, SimCpu* cpu, int time) {
+    int id = cpu->running->PDATA.group;
+    SimGroup* group = &sim->groups[id];
+    const TaskGroup* model = &group->model;
+    int ran = time - cpu->run_start;
+
+    sim->stats.groups[id].cpu_time += ran;
+    group->vtime += (double)ran / model->shares;
+    if (model->quota == 0) {
+        return;
+    }
+
+    group->used += ran;
+    sim_group_refresh(group, model, time);
+    if (group->used >= model->quota && !group->throttled) {
+        group->throttled = 1;
+        group->throttled_at = time;
+        sim->stats.groups[id].throttled_periods++;
+        Event event = { group->period_start + model->period, EVENT_PERIOD, 0, NULL, 0, id };
+        if (event_push(sim, event) != 0) {
+            sim_fail(sim, "the event queue");
+        }
+    }
+}
+
+/**
+ * @brief A throttled task group's new quota period starts
+ */
+static void sim_group_unthrottle(Sim* sim, int id, int time) {
+    SimGroup* group = &sim->groups[id];
+    sim->stats.groups[id].throttled_time += time - group->throttled_at;
+    group->throttled = 0;
+    sim_group_refresh(group, &group->model, time);
+}
+
+/**
+ * @brief Quota ticks a new run of the group may use at `time`, INT_MAX without a quota
+ * @details Runs of the group in progress on other CPUs are charged when they end, their
+ *          ticks are set aside.
+ */
+static int sim_group_left(Sim* sim, int id, int time) {
+    const TaskGroup* model = &sim->groups[id].model;
+    if (model->quota == 0) {
+        return INT_MAX;
+    }
+
+    SimGroup* group = &sim->groups[id];
+    sim_group_refresh(group, model, time);
+    int left = model->quota - group->used;
+    for (int i = 0; i < sim->cpu_count; i++) {
+        SimCpu* cpu = &sim->cpus[i];
+        if (cpu->running != NULL && cpu->running->PDATA.group == id) {
+            left -= cpu->run_end - cpu->run_start;
+        }
+    }
+    return left;
+}
+
+/**
+ * @brief Fair share pick: the group with ready processes that received the least CPU time
+ *        for its shares, throttled groups and groups out of quota excluded
+ *
+ * @return SimGroup* the group, NULL if no group may run
+ */
+static SimGroup* sim_pick_group(Sim* sim, int time) {
+    SimGroup* picked = NULL;
+    for (int i = 0; i < sim->group_count; i++) {
+        SimGroup* group = &sim->groups[i];
+        if (!group->throttled && !is_empty(&group->queue) && (picked == NULL || group->vtime < picked->vtime) &&
+            sim_group_left(sim, i, time) > 0) {
+            picked = group;
+        }
+    }
+    return picked;
+}
+
+/**
+ * @brief EDF admission control of a process about to become ready
+ *
+ * @return int 1 if the process may run, 0 if it was rejected
+ */
+static int sim_admission(Sim* sim, PCB* pcb, int time) {
+    if (sim->config.algorithm != EDF || sim->config.admission == ADMISSION_OFF || pcb->PDATA.deadline <= 0) {
+        return 1;
+    }
+
+    PCB** active = malloc((sim_ready_count(sim) + sim->cpu_count) * sizeof(PCB*));
+    if (active == NULL) {
+        return 1;
+    }
+    int count = 0;
+    for (int i = 0; i < sim->group_count; i++) {
+        for (int j = 0; j < size(&sim->groups[i].queue); j++) {
+            active[count++] = (PCB*)queue_at(&sim->groups[i].queue, j);
+        }
+    }
+    for (int i = 0; i < sim->cpu_count; i++) {
+        if (sim->cpus[i].running != NULL) {
+            sim_account_running(sim, &sim->cpus[i], time);
+            active[count++] = sim->cpus[i].running;
+        }
+    }
+
+    int feasible = policy_deadline_feasible(time, pcb, active, count);
+    free(active);
+    if (feasible) {
+        return 1;
+    }
+
+    int rejected = sim->config.admission == ADMISSION_REJECT;
+    if (rejected) {
+        sim->stats.jobs.rejected++;
+    }
+    else {
+        sim->stats.jobs.flagged++;
+    }
+    return !rejected;
+}
+
+/**
+ * @brief Bring the node's memory use and fragmentation integrals up to `time`, then take
+ *        the block allocated or freed into account
+ *
+ * @param[in] sign 1 for an allocation, -1 for a block about to be freed
+ */
+static void sim_node_update(Sim* sim, int index, const Block* block, int sign, int time) {
+    SimNode* node = &sim->nodes[index];
+    SimNodeStats* stats = &sim->stats.node[index];
+    int elapsed = time - node->changed_at;
+    stats->used_area += (double)node->used * elapsed;
+    stats->internal_area += (double)node->internal * elapsed;
+    stats->external_area += node->external * elapsed;
+    node->changed_at = time;
+
+    if (block != NULL) {
+        node->used += sign * block->size;
+        node->internal += sign * (block->size - block->allocated);
+        sim->memory_used += sign * block->size;
+    }
+    timeline_set(&sim->stats.memory.used, time, sim->memory_used);
+}
+
+/**
+ * @brief External fragmentation of the node: the part of its free memory outside its largest free block
+ */
+static void sim_node_fragmentation(SimNode* node, int memory_size) {
+    int largest = 0;
+    for (Block* block = node->memory; block != NULL; block = block->next) {
+        if (block->allocated == 0 && block->size > largest) {
+            largest = block->size;
+        }
+    }
+    int free_bytes = memory_size - node->used;
+    node->external = free_bytes > 0 ? 1 - (double)largest / free_bytes : 0;
+}
+
+/**
+ * @brief Allocate the process's memory on a node of the NUMA policy
+ * @details The home node is the node with the most free memory among those with a CPU the
+ *          process may run on. local tries it first and falls back to the other nodes, most
+ *          free memory first; strict tries only the home node; interleave tries the nodes in
+ *          turn from the one after the last allocation.
+ *
+ * @param[out] node the node of the block
+ *
+ * @return Block* the block, NULL if no node the policy allows has a block for the process
+ */
+static Block* sim_allocate(Sim* sim, const Process* proc, int* node, int time) {
+    int order[SIM_MAX_NODES];
+    int tries = sim->node_count;
+    if (sim->config.numa.policy == NUMA_INTERLEAVE) {
+        for (int i = 0; i < sim->node_count; i++) {
+            order[i] = (sim->next_node + i) % sim->node_count;
+        }
+    }
+    else {
+        // Insertion sort: nodes the process may run on first, then by free memory
+        for (int i = 0; i < sim->node_count; i++) {
+            const SimNode* candidate = &sim->nodes[i];
+            unsigned int cpus = ((1u << candidate->cpu_count) - 1) << candidate->first_cpu;
+            int allowed = proc->affinity == 0 || (proc->affinity & cpus) != 0;
+            int j = i;
+            for (; j > 0; j--) {
+                const SimNode* other = &sim->nodes[order[j - 1]];
+                unsigned int other_cpus = ((1u << other->cpu_count) - 1) << other->first_cpu;
+                int other_allowed = proc->affinity == 0 || (proc->affinity & other_cpus) != 0;
+                if (other_allowed > allowed || (other_allowed == allowed && other->used <= candidate->used)) {
+                    break;
+                }
+                order[j] = order[j - 1];
+            }
+            order[j] = i;
+        }
+        if (sim->config.numa.policy == NUMA_STRICT) {
+            tries = 1;
+        }
+    }
+
+    for (int i = 0; i < tries; i++) {
+        SimNode* candidate = &sim->nodes[order[i]];
+        Block* block = allocate_memory(candidate->memory, proc->memory_size);
+        if (block == NULL) {
+            continue;
+        }
+
+        *node = order[i];
+        sim->next_node = (order[i] + 1) % sim->node_count;
+        sim->stats.node[order[i]].allocations++;
+        sim->stats.node[order[i]].fallbacks += i > 0;
+        sim_node_update(sim, order[i], block, 1, time);
+        sim_node_fragmentation(candidate, sim->config.memory_size);
+        return block;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Give a process's memory back to its node
+ */
+static void sim_free_memory(Sim* sim, Block* block, int node, int time) {
+    sim_node_update(sim, node, block, -1, time);
+    deallocate_memory(block);
+    sim_node_fragmentation(&sim->nodes[node], sim->config.memory_size);
+}
+
+/**
+ * @brief Create the PCB of a process that got its memory (on `node`) and make it ready
+ */
+static void sim_admit(Sim* sim, Process* proc, Block* block, int node, int time) {
+    PCB* pcb = malloc(sizeof(PCB));
+    if (pcb == NULL) {
+        sim_fail(sim, "a process control block");
+        free(proc);
+        return;
+    }
+    pcb->pid = proc->id; // no real process behind it
+    pcb->PDATA = *proc;
+    pcb->remaining_time = proc->runtime;
+    pcb->start_time = -1;
+    pcb->wait_time = 0;
+    pcb->state = "arrived";
+    pcb->memory_block = block;
+    pcb->pass = 0;
+    pcb->share_start = 0;
+    pcb->intended_service = 0;
+    pcb->predicted_runtime = predictor_enabled(&sim->stats.predictor) ? predictor_estimate(&sim->stats.predictor, proc) : 0;
+    pcb->io_next = 0;
+    pcb->io_time = 0;
+    pcb->blocked_at = 0;
+    pcb->last_cpu = -1;
+    pcb->work_carry = 0;
+    pcb->run_time = 0;
+    pcb->node = block != NULL ? node : -1;
+    pcb->swap_state = SWAP_RESIDENT;
+    pcb->swap_pinned = 1;
+    pcb->swapped_at = 0;
+    pcb->swap_count = 0;
+    free(proc);
+
+    if (block != NULL) {
+        memory_stats_admit(&sim->stats.memory, pcb->PDATA.memory_size, pcb->PDATA.arrival_time, time);
+        sim->pending_overhead += sim->config.costs.allocation;
+        if (sim->config.memory_log != NULL) {
+            write_memory_event(sim->config.memory_log, pcb->PDATA.id, block, 1, time);
+        }
+    }
+
+    if (!sim_admission(sim, pcb, time)) {
+        pcb->state = "rejected";
+        sim_log_event(sim, pcb, time);
+        if (block != NULL) {
+            if (sim->config.memory_log != NULL) {
+                write_memory_event(sim->config.memory_log, pcb->PDATA.id, block, 0, time);
+            }
+            sim_free_memory(sim, block, node, time);
+        }
+        free(pcb);
+        sim->stats.rejected++;
+        return;
+    }
+
+    if (policy_is_proportional_share(sim->config.algorithm)) {
+        share_clock_join(&sim->share_clock, pcb, time);
+    }
+    sim_enqueue(sim, pcb);
+
+    if (sim->admitted != NULL && block != NULL) {
+        if (sim->admitted_count == sim->admitted_capacity) {
+            PCB** admitted = realloc(sim->admitted, 2 * sim->admitted_capacity * sizeof(PCB*));
+            if (admitted == NULL) {
+                sim_fail(sim, "the admitted processes");
+                return;
+            }
+            sim->admitted = admitted;
+            sim->admitted_capacity *= 2;
+        }
+        sim->admitted[sim->admitted_count++] = pcb;
+    }
+}
+
+/**
+ * @brief Ticks the swap device takes to move the process's memory
+ */
+static int sim_swap_time(Sim* sim, const PCB* pcb) {
+    const SimSwap* swap = &sim->config.swap;
+    return swap->latency + (pcb->PDATA.memory_size + swap->bandwidth - 1) / swap->bandwidth;
+}
+
+/**
+ * @brief Start the next transfer queued on the idle swap device
+ */
+static void sim_swap_start(Sim* sim, int time) {
+    PCB* pcb = (PCB*)dequeue(&sim->swap_queue, 1);
+    int ticks = sim_swap_time(sim, pcb);
+    sim->swapping = pcb;
+    sim->stats.swap.busy_time += ticks;
+    Event event = { time + ticks, EVENT_SWAP_END, 0, NULL, 0, 0 };
+    if (event_push(sim, event) != 0) {
+        sim_fail(sim, "the event queue");
+    }
+}
+
+/**
+ * @brief Queue a swap-out or a swap-in of the process on the swap device
+ */
+static void sim_swap_request(Sim* sim, PCB* pcb, SwapState state, int time) {
+    pcb->swap_state = state;
+    enqueue(&sim->swap_queue, pcb, 0);
+    if (sim->swapping == NULL) {
+        sim_swap_start(sim, time);
+    }
+}
+
+/**
+ * @brief The swap device finished its transfer: a swapped-out process gives its memory back,
+ *        a swapped-in one may run again, and the device takes the next transfer
+ */
+static void sim_swap_end(Sim* sim, int time) {
+    PCB* pcb = sim->swapping;
+    sim->swapping = NULL;
+    if (pcb->swap_state == SWAP_OUT) {
+        if (sim->config.memory_log != NULL) {
+            write_memory_event(sim->config.memory_log, pcb->PDATA.id, pcb->memory_block, 0, time);
+        }
+        sim_free_memory(sim, pcb->memory_block, pcb->node, time);
+        pcb->memory_block = NULL;
+        pcb->node = -1;
+        pcb->swap_state = SWAP_SWAPPED;
+        sim->swap_outs_pending--;
+        sim->stats.swap.swap_outs++;
+        sim->stats.swap.bytes_out += pcb->PDATA.memory_size;
+    }
+    else {
+        pcb->swap_state = SWAP_RESIDENT;
+        sim->stats.swap.swap_ins++;
+        sim->stats.swap.bytes_in += pcb->PDATA.memory_size;
+        running_stat_push(&sim->stats.swap.out_time, time - pcb->swapped_at);
+    }
+
+    if (!is_empty(&sim->swap_queue)) {
+        sim_swap_start(sim, time);
+    }
+}
+
+/**
+ * @brief A swapped-out process is due to run: swap it in if memory is found for it, else
+ *        it holds the memory freed from now on (the first such process does)
+ */
+static void sim_swap_due(Sim* sim, PCB* pcb, int time) {
+    if (pcb->swap_state != SWAP_SWAPPED || (sim->swap_wanted != NULL && sim->swap_wanted != pcb)) {
+        return;
+    }
+
+    int node;
+    Block* block = sim_allocate(sim, &pcb->PDATA, &node, time);
+    if (block == NULL) {
+        sim->swap_wanted = pcb;
+        return;
+    }
+    if (sim->config.memory_log != NULL) {
+        write_memory_event(sim->config.memory_log, pcb->PDATA.id, block, 1, time);
+    }
+    pcb->memory_block = block;
+    pcb->node = node;
+    pcb->swap_pinned = 1;
+    sim->swap_wanted = NULL;
+    sim_swap_request(sim, pcb, SWAP_IN, time);
+}
+
+static int sim_is_running(Sim* sim, const PCB* pcb) {
+    for (int i = 0; i < sim->cpu_count; i++) {
+        if (sim->cpus[i].running == pcb) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief How urgent the scheduling policy finds the process at `time`, lower first
+ * @details The ready queue priority, except that more lottery tickets and a higher HRRN
+ *          response ratio are more urgent. Every process is equally urgent under RR.
+ */
+static double sim_urgency(Sim* sim, PCB* pcb, int time) {
+    long long key = policy_priority(sim->config.algorithm, pcb);
+    switch (sim->config.algorithm) {
+    case LOTTERY:
+        return -(double)key;
+    case HRRN: {
+        long long service = key & 0xFFFFFFFFLL;
+        if (service <= 0) {
+            service = 1;
+        }
+        return -(double)(time - (key >> 32) + service) / service;
+    }
+    default:
+        return (double)key;
+    }
+}
+
+/**
+ * @brief Swap out a process to make room when memory is short, one swap-out at a time
+ * @details Room is made for the swapped-out process due to run, or else for the oldest
+ *          process waiting for memory. The victim holds a block at least as large as that
+ *          process needs and has run since it got its memory; processes blocked on I/O go
+ *          first, then ready processes the scheduling policy finds no more urgent, least
+ *          urgent first, and the smaller block among equals.
+ */
+static void sim_swap_out(Sim* sim, int time) {
+    if (sim->admitted == NULL || sim->swap_outs_pending > 0) {
+        return;
+    }
+
+    // A process still waiting for memory is ranked as the PCB sim_admit would give it
+    PCB waiting;
+    PCB* requester = sim->swap_wanted;
+    if (requester == NULL && oq_size(sim->waiting) > 0) {
+        OrderEntry* oldest = NULL;
+        for (unsigned int orders = sim->waiting->orders; orders != 0; orders &= orders - 1) {
+            OrderEntry* entry = oq_front(sim->waiting, __builtin_ctz(orders));
+            if (oldest == NULL || entry->seq < oldest->seq) {
+                oldest = entry;
+            }
+        }
+        memset(&waiting, 0, sizeof(PCB));
+        waiting.PDATA = *(const Process*)oldest->item;
+        waiting.remaining_time = waiting.PDATA.runtime;
+        waiting.pass = sim->share_clock.pass;
+        waiting.predicted_runtime = predictor_enabled(&sim->stats.predictor) ? predictor_estimate(&sim->stats.predictor, &waiting.PDATA) : 0;
+        requester = &waiting;
+    }
+    if (requester == NULL) {
+        return;
+    }
+
+    int need = 1 << block_order(requester->PDATA.memory_size);
+    double requester_urgency = sim_urgency(sim, requester, time);
+    double victim_urgency = 0;
+    PCB* victim = NULL;
+    int victim_blocked = 0;
+    for (int i = 0; i < sim->admitted_count; i++) {
+        PCB* pcb = sim->admitted[i];
+        if (pcb->swap_state != SWAP_RESIDENT || pcb->swap_pinned || pcb->memory_block->size < need ||
+            sim_is_running(sim, pcb)) {
+            continue;
+        }
+        int blocked = strcmp(pcb->state, "blocked") == 0;
+        double urgency = sim_urgency(sim, pcb, time);
+        if (!blocked && urgency < requester_urgency) {
+            continue;
+        }
+        if (victim == NULL || blocked > victim_blocked ||
+            (blocked == victim_blocked && (urgency > victim_urgency ||
+                (urgency == victim_urgency && pcb->memory_block->size < victim->memory_block->size)))) {
+            victim = pcb;
+            victim_blocked = blocked;
+            victim_urgency = urgency;
+        }
+    }
+    if (victim == NULL) {
+        return;
+    }
+
+    victim->swapped_at = time;
+    victim->swap_count++;
+    sim->swap_outs_pending++;
+    sim_swap_request(sim, victim, SWAP_OUT, time);
+}
+
+/**
+ * @brief Admit the waiting processes the admission policy picks, as long as one gets memory
+ * @details The policy picks an order from the free blocks of all nodes; the processes of that
+ *          order are tried oldest first, since the NUMA policy may keep some of them off the
+ *          nodes with room. An order none of them gets memory for is not picked again until
+ *          the next admission.
+ */
+static void sim_admit_waiting(Sim* sim, int time) {
+    sim->memory_held = 0;
+
+    // A swapped-out process due to run goes before any new process
+    if (sim->swap_wanted != NULL) {
+        sim_swap_due(sim, sim->swap_wanted, time);
+        if (sim->swap_wanted != NULL) {
+            sim->memory_held = 1;
+            return;
+        }
+    }
+    OrderEntry* prev[ORDER_QUEUE_ORDERS];
+    OrderEntry* heads[ORDER_QUEUE_ORDERS];
+    unsigned int waiting = 0;
+    while (oq_size(sim->waiting) > 0) {
+        // (Re)start from the oldest process of every order
+        if (waiting == 0) {
+            waiting = sim->waiting->orders;
+            for (unsigned int orders = waiting; orders != 0; orders &= orders - 1) {
+                int order = __builtin_ctz(orders);
+                prev[order] = NULL;
+                heads[order] = oq_front(sim->waiting, order);
+            }
+        }
+        unsigned int free = 0;
+        for (int i = 0; i < sim->node_count; i++) {
+            free |= free_orders(sim->nodes[i].memory);
+        }
+
+        int held;
+        int order = admit_pick(&sim->config.admit, heads, waiting, free, block_order(sim->config.memory_size), time, &held);
+        if (order < 0) {
+            sim->memory_held = held;
+            return;
+        }
+
+        Process* proc = (Process*)heads[order]->item;
+        int node;
+        Block* block = sim_allocate(sim, proc, &node, time);
+        if (block == NULL) {
+            if (held) {
+                sim->memory_held = 1;
+                return;
+            }
+            prev[order] = heads[order];
+            heads[order] = heads[order]->next;
+            if (heads[order] == NULL) {
+                waiting &= ~(1u << order);
+                if (waiting == 0) {
+                    return;
+                }
+            }
+            continue;
+        }
+
+        // An admission can be rejected and free its memory again, look from the oldest once more
+        oq_remove(sim->waiting, order, prev[order]);
+        sim_admit(sim, proc, block, node, time);
+        waiting = 0;
+    }
+}
+
+static void sim_arrive(Sim* sim, Process* proc, int time) {
+    if (sim->config.allocator == SIM_ALLOC_NONE) {
+        sim_admit(sim, proc, NULL, -1, time);
+        return;
+    }
+
+    // Behind an aged or a swapped-out process, newcomers wait too instead of taking the memory it waits for
+    int node;
+    Block* block = sim->memory_held ? NULL : sim_allocate(sim, proc, &node, time);
+    if (block == NULL) {
+        oq_push(sim->waiting, proc, block_order(proc->memory_size), time);
+        sim->stats.memory.waited++;
+        return;
+    }
+    sim_admit(sim, proc, block, node, time);
+}
+
+/**
+ * @brief Execution log line of the run ending at `time`, the caller ends it
+ */
+static void sim_log_run(Sim* sim, SimCpu* cpu, int time) {
+    fprintf(sim->config.execution_log, "P%d (burst %d) runs %d → %d", cpu->running->PDATA.id,
+        cpu->running->PDATA.runtime, cpu->run_start, time);
+    if (sim->cpu_count > 1) {
+        fprintf(sim->config.execution_log, " on CPU %d", (int)(cpu - sim->cpus));
+    }
+}
+
+/**
+ * @brief Take the CPU's process off it, the run ends at `time`
+ */
+static PCB* sim_release_cpu(Sim* sim, SimCpu* cpu, int time) {
+    PCB* pcb = cpu->running;
+    cpu->running = NULL;
+    cpu->generation++;
+    cpu->last_end_time = time;
+    sim->running_count--;
+    return pcb;
+}
+
+static void sim_finish(Sim* sim, SimCpu* cpu, int time) {
+    if (sim->config.execution_log != NULL) {
+        sim_log_run(sim, cpu, time);
+        fprintf(sim->config.execution_log, " and finishes at %d\n\n", time);
+    }
+
+    sim_group_charge(sim, cpu, time);
+    PCB* pcb = sim_release_cpu(sim, cpu, time);
+    pcb->state = "finished";
+    if (predictor_enabled(&sim->stats.predictor)) {
+        predictor_observe(&sim->stats.predictor, &pcb->PDATA, pcb->predicted_runtime);
+    }
+    if (policy_is_proportional_share(sim->config.algorithm)) {
+        share_clock_leave(&sim->share_clock, pcb, time);
+    }
+    sim_log_event(sim, pcb, time);
+
+    int TA = time - pcb->PDATA.arrival_time;
+    double WTA = ((double)TA) / pcb->PDATA.runtime;
+    perf_stats_record(&sim->stats.perf, TA, WTA, pcb->wait_time, pcb->start_time - pcb->PDATA.arrival_time);
+    TaskGroupStats* group = &sim->stats.groups[pcb->PDATA.group];
+    running_stat_push(&group->ta, TA);
+    running_stat_push(&group->wait, pcb->wait_time);
+    histogram_record(&group->ta_hist, TA);
+    histogram_record(&group->response_hist, pcb->start_time - pcb->PDATA.arrival_time);
+    job_table_push(&sim->stats.jobs, pcb->PDATA.arrival_time, pcb->start_time, time, pcb->PDATA.runtime,
+        pcb->wait_time, pcb->PDATA.priority, pcb->PDATA.memory_size, pcb->PDATA.deadline, pcb->intended_service);
+    if (sim->admitted != NULL && pcb->memory_block != NULL) {
+        running_stat_push(pcb->swap_count > 0 ? &sim->stats.swap.ta_swapped : &sim->stats.swap.ta_resident, TA);
+        for (int i = 0; i < sim->admitted_count; i++) {
+            if (sim->admitted[i] == pcb) {
+                sim->admitted[i] = sim->admitted[--sim->admitted_count];
+                break;
+            }
+        }
+    }
+
+    if (pcb->memory_block != NULL) {
+        if (sim->config.memory_log != NULL) {
+            write_memory_event(sim->config.memory_log, pcb->PDATA.id, pcb->memory_block, 0, time);
+        }
+        sim_free_memory(sim, pcb->memory_block, pcb->node, time);
+    }
+    free(pcb);
+
+    sim->stats.finished++;
+    sim->stats.end_time = time;
+}
+
+/**
+ * @brief Take the running process off the CPU (quantum expiry, preemption or an I/O request)
+ *
+ * @param[in] state "stopped", or "blocked" for an I/O request
+ */
+static PCB* sim_stop_running(Sim* sim, SimCpu* cpu, int time, char* state) {
+    PCB* pcb = cpu->running;
+
+    // Taken off while the CPU still pays the dispatch overhead: the unspent overhead is given back
+    if (time < cpu->accounted_until) {
+        sim->stats.overhead_time -= cpu->accounted_until - time;
+        cpu->accounted_until = time;
+        cpu->run_start = time;
+        if (pcb->start_time > time) {
+            pcb->start_time = -1; // it never ran
+        }
+    }
+
+    if (sim->config.execution_log != NULL) {
+        sim_log_run(sim, cpu, time);
+        fprintf(sim->config.execution_log, " (rem %d)\n\n", pcb->remaining_time);
+    }
+
+    pcb->state = state;
+    pcb->run_time += time - cpu->run_start;
+    sim_log_event(sim, pcb, time);
+    policy_charge(sim->config.algorithm, pcb, time - cpu->run_start);
+    sim_group_charge(sim, cpu, time);
+    return sim_release_cpu(sim, cpu, time);
+}
+
+/**
+ * @brief Whether the process has run up to its next I/O request
+ */
+static int sim_io_due(PCB* pcb) {
+    return pcb->io_next < pcb->PDATA.io_count &&
+        pcb->PDATA.runtime - pcb->remaining_time == pcb->PDATA.io[pcb->io_next].after;
+}
+
+/**
+ * @brief Bring the I/O busy and CPU / I/O overlap times up to `time`
+ */
+static void sim_account_io(Sim* sim, int time) {
+    if (sim->busy_devices > 0) {
+        sim->stats.io.io_busy_time += time - sim->io_accounted_until;
+        if (sim->running_count > 0) {
+            sim->stats.io.overlap_time += time - sim->io_accounted_until;
+        }
+    }
+    sim->io_accounted_until = time;
+}
+
+static int sim_io_pending(SimDevice* dev) {
+    return !is_empty(&dev->queue) || (dev->disk != NULL && dq_size(dev->disk) > 0);
+}
+
+/**
+ * @brief Serve the next request queued on an idle device
+ * @details A disk moves its head to the request's cylinder, the seek and rotation are
+ *          part of the service time.
+ */
+static void sim_io_start(Sim* sim, int device, int time) {
+    SimDevice* dev = &sim->devices[device];
+    const IoDevice* model = &dev->model;
+    PCB* pcb;
+    int distance = 0;
+    if (dev->disk != NULL) {
+        int cylinder = disk_next(&model->disk, dev->disk, &dev->head, &distance);
+        pcb = (PCB*)dq_pop(dev->disk, cylinder);
+    }
+    else {
+        pcb = (PCB*)dequeue(&dev->queue, 1);
+        if (model->is_disk) {
+            distance = disk_move(&dev->head, pcb->PDATA.io[pcb->io_next - 1].cylinder);
+        }
+    }
+    const IoBurst* burst = &pcb->PDATA.io[pcb->io_next - 1];
+    int service = model->is_disk ? disk_service_time(&model->disk, distance, &sim->rng) : io_service_time(model, burst, &sim->rng);
+
+    IoDeviceStats* stats = &sim->stats.io.device[device];
+    stats->requests++;
+    stats->busy_time += service;
+    stats->writes += burst->write;
+    stats->seek_distance += distance;
+    running_stat_push(&stats->wait, time - pcb->blocked_at);
+    running_stat_push(&stats->service, service);
+    histogram_record(&stats->service_hist, service);
+
+    dev->serving = pcb;
+    sim->busy_devices++;
+    Event event = { time + service, EVENT_IO_END, 0, NULL, 0, device };
+    if (event_push(sim, event) != 0) {
+        sim_fail(sim, "the event queue");
+    }
+}
+
+/**
+ * @brief The running process issues its next I/O request and leaves the CPU
+ */
+static void sim_block(Sim* sim, SimCpu* cpu, int time) {
+    PCB* pcb = sim_stop_running(sim, cpu, time, "blocked");
+    const IoBurst* burst = &pcb->PDATA.io[pcb->io_next++];
+    int device = burst->device;
+    if (policy_is_proportional_share(sim->config.algorithm)) {
+        share_clock_leave(&sim->share_clock, pcb, time);
+    }
+    pcb->blocked_at = time;
+    sim->stats.io.requests++;
+
+    if (sim->devices[device].disk != NULL) {
+        dq_push(sim->devices[device].disk, pcb, burst->cylinder);
+    }
+    else {
+        enqueue(&sim->devices[device].queue, pcb, 0);
+    }
+    if (sim->devices[device].serving == NULL) {
+        sim_io_start(sim, device, time);
+    }
+}
+
+/**
+ * @brief A device finished its request: the process is woken and the device takes the next one
+ */
+static void sim_io_end(Sim* sim, int device, int time) {
+    SimDevice* dev = &sim->devices[device];
+    PCB* pcb = dev->serving;
+    dev->serving = NULL;
+    sim->busy_devices--;
+    pcb->io_time += time - pcb->blocked_at;
+
+    if (sim->woken_count == sim->woken_capacity) {
+        PCB** woken = realloc(sim->woken, 2 * sim->woken_capacity * sizeof(PCB*));
+        if (woken == NULL) {
+            sim_fail(sim, "the processes back from I/O");
+            return;
+        }
+        sim->woken = woken;
+        sim->woken_capacity *= 2;
+    }
+    sim->woken[sim->woken_count++] = pcb;
+
+    if (sim_io_pending(dev)) {
+        sim_io_start(sim, device, time);
+    }
+}
+
+/**
+ * @brief Start a run of the process on the idle CPU
+ */
+static void sim_run(Sim* sim, SimCpu* cpu, PCB* pcb, int time) {
+    int id = (int)(cpu - sim->cpus);
+    if (time > cpu->last_end_time) {
+        if (sim->config.execution_log != NULL) {
+            fprintf(sim->config.execution_log, "Idle from %d → %d", cpu->last_end_time, time);
+            if (sim->cpu_count > 1) {
+                fprintf(sim->config.execution_log, " on CPU %d", id);
+            }
+            fprintf(sim->config.execution_log, "\n\n");
+        }
+        sim->stats.idle_time += time - cpu->last_end_time;
+    }
+
+    // The CPU pays the overhead first, the process starts running afterwards
+    int overhead = sim->pending_overhead;
+    sim->pending_overhead = 0;
+    if (pcb->start_time == -1) {
+        overhead += sim->config.costs.first_dispatch;
+    }
+    else if (pcb->PDATA.id != cpu->last_run_id) {
+        overhead += sim->config.costs.context_switch;
+        sim->stats.context_switches++;
+    }
+    if (pcb->last_cpu >= 0 && pcb->last_cpu != id) {
+        overhead += sim->config.costs.migration;
+        sim->stats.cpu[id].migrations++;
+    }
+    sim->stats.overhead_time += overhead;
+    cpu->last_run_id = pcb->PDATA.id;
+    pcb->last_cpu = id;
+    pcb->swap_pinned = 0;
+    int start = time + overhead;
+
+    if (pcb->start_time == -1) {
+        pcb->state = "started";
+        pcb->start_time = start;
+        pcb->wait_time = start - pcb->PDATA.arrival_time;
+    }
+    else {
+        pcb->state = "resumed";
+        pcb->wait_time = (start - pcb->PDATA.arrival_time) - pcb->run_time - pcb->io_time;
+    }
+    sim_log_event(sim, pcb, start);
+    share_clock_dispatch(&sim->share_clock, pcb);
+
+    // Work up to the end of the burst, in ticks of this CPU
+    int target = pcb->remaining_time;
+    if (pcb->io_next < pcb->PDATA.io_count) {
+        target = pcb->PDATA.io[pcb->io_next].after - (pcb->PDATA.runtime - pcb->remaining_time);
+    }
+    cpu->rate = sim_rate(sim, cpu, pcb);
+    double ticks = ceil((target - pcb->work_carry) / cpu->rate - SIM_WORK_EPSILON);
+    int slice = ticks < 1 ? 1 : ticks > INT_MAX - start ? INT_MAX - start : (int)ticks;
+    if (policy_uses_quantum(sim->config.algorithm) && sim->config.quantum < slice) {
+        slice = sim->config.quantum;
+    }
+    if (sim->group_slice > 0 && sim->group_slice < slice) {
+        slice = sim->group_slice;
+    }
+
+    // A run never crosses the end of its group's quota period nor exceeds what is left of the quota
+    const TaskGroup* model = &sim->groups[pcb->PDATA.group].model;
+    if (model->quota > 0) {
+        SimGroup* group = &sim->groups[pcb->PDATA.group];
+        int left = sim_group_left(sim, pcb->PDATA.group, start);
+        if (group->period_start + model->period - start < left) {
+            left = group->period_start + model->period - start;
+        }
+        if (left < slice) {
+            slice = left;
+        }
+    }
+
+    cpu->running = pcb;
+    cpu->run_start = start;
+    cpu->run_end = start + slice;
+    cpu->accounted_until = start;
+    cpu->target = target;
+    cpu->work_done = 0;
+    cpu->carry = pcb->work_carry;
+    cpu->generation++;
+    cpu->dispatched_at = time;
+    sim->running_count++;
+
+    Event event = { start + slice, EVENT_RUN_END, 0, NULL, cpu->generation, id };
+    if (event_push(sim, event) != 0) {
+        sim_fail(sim, "the event queue");
+    }
+}
+
+/**
+ * @brief Idle CPU the process goes to: the CPU it ran on last if it is idle, the fastest
+ *        idle CPU otherwise (lowest number among equals), within its affinity
+ * @details Speed counts the remote penalty, so a CPU of the node holding the process's
+ *          memory wins over an equally fast one of another node.
+ *
+ * @return SimCpu* the CPU, NULL if no CPU the process may run on is idle
+ */
+static SimCpu* sim_place(Sim* sim, PCB* pcb) {
+    unsigned int affinity = pcb->PDATA.affinity;
+    if (pcb->last_cpu >= 0 && sim->cpus[pcb->last_cpu].running == NULL) {
+        return &sim->cpus[pcb->last_cpu];
+    }
+
+    SimCpu* placed = NULL;
+    double placed_rate = 0;
+    for (int i = 0; i < sim->cpu_count; i++) {
+        SimCpu* cpu = &sim->cpus[i];
+        if (cpu->running == NULL && (affinity == 0 || (affinity >> i & 1)) &&
+            (placed == NULL || sim_rate(sim, cpu, pcb) > placed_rate)) {
+            placed = cpu;
+            placed_rate = sim_rate(sim, cpu, pcb);
+        }
+    }
+    return placed;
+}
+
+/**
+ * @brief Fill the idle CPUs: the fair share picks a task group, the policy a process in it,
+ *        and the process goes to its last CPU or the fastest idle one
+ * @details A process whose affinity allows none of the idle CPUs, or whose memory is not
+ *          back from the swap device, is passed over and goes back to its ready queue
+ *          afterwards; a swapped-out one is swapped in.
+ */
+static void sim_dispatch(Sim* sim, int time) {
+    int passed_count = 0;
+
+    while (sim->running_count < sim->cpu_count) {
+        SimGroup* group = sim_pick_group(sim, time);
+        if (group == NULL) {
+            break;
+        }
+
+        queue_advance(&group->queue, time);
+        PCB* pcb = (PCB*)dequeue(&group->queue, 1);
+        SimCpu* cpu = NULL;
+        if (pcb->swap_state == SWAP_RESIDENT) {
+            cpu = sim_place(sim, pcb);
+        }
+        else {
+            sim_swap_due(sim, pcb, time);
+        }
+        if (cpu == NULL) {
+            if (passed_count == sim->passed_capacity) {
+                PCB** passed = realloc(sim->passed, 2 * sim->passed_capacity * sizeof(PCB*));
+                if (passed == NULL) {
+                    enqueue(&group->queue, pcb, policy_queue_key(sim->config.algorithm, sim->config.aging_interval, pcb));
+                    sim_fail(sim, "the processes passed over");
+                    break;
+                }
+                sim->passed = passed;
+                sim->passed_capacity *= 2;
+            }
+            sim->passed[passed_count++] = pcb;
+            continue;
+        }
+
+        if (group->vtime > sim->min_vtime) {
+            sim->min_vtime = group->vtime;
+        }
+        sim_run(sim, cpu, pcb, time);
+    }
+
+    for (int i = 0; i < passed_count; i++) {
+        PCB* pcb = sim->passed[i];
+        enqueue(&sim->groups[pcb->PDATA.group].queue, pcb,
+            policy_queue_key(sim->config.algorithm, sim->config.aging_interval, pcb));
+    }
+}
+
+/**
+ * @brief CPU whose process the front of its ready queue preempts, the least urgent such
+ *        process when there are several; processes dispatched at `time` are not preempted
+ * @details A front that is swapped out preempts nothing yet, it is swapped in first.
+ *
+ * @return SimCpu* the CPU, NULL if no process is preempted
+ */
+static SimCpu* sim_preemption_victim(Sim* sim, int time) {
+    SimCpu* victim = NULL;
+    for (int i = 0; i < sim->cpu_count; i++) {
+        SimCpu* cpu = &sim->cpus[i];
+        if (cpu->running == NULL || cpu->dispatched_at == time) {
+            continue;
+        }
+        sim_account_running(sim, cpu, time);
+        PCB* next = (PCB*)front(&sim->groups[cpu->running->PDATA.group].queue);
+        if (next != NULL && next->swap_state != SWAP_RESIDENT) {
+            if (policy_should_preempt(sim->config.algorithm, cpu->running, next)) {
+                sim_swap_due(sim, next, time); // it preempts once it is back in memory
+            }
+            continue;
+        }
+        if (policy_should_preempt(sim->config.algorithm, cpu->running, next) &&
+            (next->PDATA.affinity == 0 || (next->PDATA.affinity >> i & 1)) &&
+            (victim == NULL ||
+                policy_priority(sim->config.algorithm, cpu->running) > policy_priority(sim->config.algorithm, victim->running))) {
+            victim = cpu;
+        }
+    }
+    return victim;
+}
+
+/**
+ * @brief Process every event at `time`
+ * @details The running process finishes, is stopped or blocks on I/O, waiting processes
+ *          get freed memory, new arrivals are admitted, processes back from I/O and the
+ *          stopped process go back to the ready queue, then preemption and dispatch decisions.
+ *          This is not the IPC scheduler's order: its RR queue puts a new arrival behind
+ *          the previous arrival, ahead of a process stopped since, and it sees arrivals and
+ *          finishes through the message queue and signals, so the two schedules can differ.
+ */
+static void sim_step(Sim* sim, int time) {
+    int run_ended[SIM_MAX_CPUS] = { 0 };
+    sim->arrival_count = 0;
+    sim->woken_count = 0;
+    sim_account_io(sim, time);
+
+    while (sim->event_count > 0 && sim->events[0].time == time) {
+        Event event = event_pop(sim);
+        sim->stats.events++;
+
+        if (event.type == EVENT_RUN_END) {
+            SimCpu* cpu = &sim->cpus[event.index];
+            run_ended[event.index] |= (cpu->running != NULL && event.generation == cpu->generation);
+            continue;
+        }
+        if (event.type == EVENT_IO_END) {
+            sim_io_end(sim, event.index, time);
+            continue;
+        }
+        if (event.type == EVENT_PERIOD) {
+            sim_group_unthrottle(sim, event.index, time);
+            continue;
+        }
+        if (event.type == EVENT_SWAP_END) {
+            sim_swap_end(sim, time);
+            continue;
+        }
+
+        if (sim->arrival_count == sim->arrival_capacity) {
+            Process** arrivals = realloc(sim->arrivals, 2 * sim->arrival_capacity * sizeof(Process*));
+            if (arrivals == NULL) {
+                free(event.proc);
+                sim_fail(sim, "the arrivals");
+                return;
+            }
+            sim->arrivals = arrivals;
+            sim->arrival_capacity *= 2;
+        }
+        sim->arrivals[sim->arrival_count++] = event.proc;
+    }
+    if (sim->failed) {
+        return;
+    }
+
+    PCB* stopped[SIM_MAX_CPUS];
+    int stopped_count = 0;
+    for (int i = 0; i < sim->cpu_count; i++) {
+        SimCpu* cpu = &sim->cpus[i];
+        if (!run_ended[i]) {
+            continue;
+        }
+        sim_account_running(sim, cpu, time);
+        if (cpu->running->remaining_time <= 0) {
+            sim_finish(sim, cpu, time);
+        }
+        else if (sim_io_due(cpu->running)) {
+            sim_block(sim, cpu, time);
+        }
+        else {
+            stopped[stopped_count++] = sim_stop_running(sim, cpu, time, "stopped");
+        }
+    }
+
+    sim_admit_waiting(sim, time);
+    for (int i = 0; i < sim->arrival_count; i++) {
+        sim_arrive(sim, sim->arrivals[i], time);
+    }
+
+    for (int i = 0; i < sim->woken_count; i++) {
+        PCB* pcb = sim->woken[i];
+        pcb->state = "ready";
+        sim_log_event(sim, pcb, time);
+        if (policy_is_proportional_share(sim->config.algorithm)) {
+            share_clock_join(&sim->share_clock, pcb, time);
+        }
+        sim_enqueue(sim, pcb);
+    }
+
+    for (int i = 0; i < stopped_count; i++) {
+        sim_enqueue(sim, stopped[i]);
+    }
+
+    // Idle CPUs first, then processes that ran before this step may be preempted
+    int preempted = 0;
+    sim_dispatch(sim, time);
+    while (policy_is_preemptive(sim->config.algorithm) && preempted < sim->cpu_count) {
+        SimCpu* victim = sim_preemption_victim(sim, time);
+        if (victim == NULL) {
+            break;
+        }
+        sim_enqueue(sim, sim_stop_running(sim, victim, time, "stopped"));
+        sim_dispatch(sim, time);
+        preempted++;
+    }
+    sim_swap_out(sim, time);
+
+    sim->stats.current_time = time + 1;
+}
+
+/**
+ * @brief Simulate every event strictly before `time`
+ * @details Afterwards processes can be submitted with arrival_time >= `time`.
+ *          Pass SIM_TIME_MAX to run until every submitted process has finished.
+ *
+ * @return long long number of submitted processes that have not finished yet, -1 when a
+ *         step failed to allocate memory (the simulation stops there)
+ */
+long long sim_run_until(Sim* sim, int time) {
+    while (!sim->failed && sim->event_count > 0 && sim->events[0].time < time) {
+        sim_step(sim, sim->events[0].time);
+    }
+    if (sim->failed) {
+        return -1;
+    }
+
+    if (time != SIM_TIME_MAX && time > sim->stats.current_time) {
+        sim->stats.current_time = time;
+    }
+
+    return sim->stats.submitted - sim->stats.finished - sim->stats.rejected;
+}
+
+/**
+ * @brief Submit a whole trace and run it to completion
+ * @details Arrivals are submitted in order, advancing the simulation up to each one.
+ *
+ * @param[in] processes processes sorted by arrival time
+ * @param[in] count number of processes
+ *
+ * @return int number of processes rejected by sim_submit, -1 when the simulation failed
+ */
+int sim_run_trace(Sim* sim, const Process* processes, int count) {
+    int rejected = 0;
+    for (int i = 0; i < count; i++) {
+        if (sim_run_until(sim, processes[i].arrival_time) < 0) {
+            return -1;
+        }
+        rejected += sim_submit(sim, &processes[i]) != 0;
+    }
+    return sim_run_until(sim, SIM_TIME_MAX) < 0 ? -1 : rejected;
+}
+
+/**
+ * @brief Statistics of the simulation so far
+ * @details The idle time includes CPUs that have been idle since their last run ended
+ *          before end_time.
+ */
+const SimStats* sim_stats(Sim* sim) {
+    for (int i = 0; i < sim->cpu_count; i++) {
+        SimCpu* cpu = &sim->cpus[i];
+        if (cpu->running == NULL && cpu->last_end_time < sim->stats.end_time) {
+            sim->stats.idle_time += sim->stats.end_time - cpu->last_end_time;
+            cpu->last_end_time = sim->stats.end_time;
+        }
+    }
+    for (int i = 0; i < sim->node_count; i++) {
+        if (sim->nodes[i].changed_at < sim->stats.end_time) {
+            sim_node_update(sim, i, NULL, 0, sim->stats.end_time);
+        }
+    }
+    return &sim->stats;
+}
+
+/**
+ * @brief Free the simulation, including processes that have not finished
+ */
+void sim_destroy(Sim* sim) {
+    if (sim == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < sim->event_count; i++) {
+        free(sim->events[i].proc);
+    }
+    free(sim->events);
+    free(sim->arrivals);
+    free(sim->woken);
+    free(sim->passed);
+    if (sim->admitted != NULL) {
+        free_queue(&sim->swap_queue); // its processes are in the ready or device queues
+        free(sim->admitted);
+    }
+
+    for (int i = 0; i < sim->device_count; i++) {
+        while (!is_empty(&sim->devices[i].queue)) {
+            free(dequeue(&sim->devices[i].queue, 1));
+        }
+        free_queue(&sim->devices[i].queue);
+        if (sim->devices[i].disk != NULL) {
+            while (dq_size(sim->devices[i].disk) > 0) {
+                free(dq_pop(sim->devices[i].disk, dq_ceiling(sim->devices[i].disk, 0)));
+            }
+            dq_free(sim->devices[i].disk);
+        }
+        free(sim->devices[i].serving);
+    }
+
+    for (int i = 0; i < sim->group_count; i++) {
+        while (!is_empty(&sim->groups[i].queue)) {
+            free(dequeue(&sim->groups[i].queue, 1));
+        }
+        free_queue(&sim->groups[i].queue);
+    }
+    free(sim->groups);
+    free(sim->stats.groups);
+    for (int i = 0; i < sim->cpu_count; i++) {
+        free(sim->cpus[i].running);
+    }
+
+    if (sim->waiting != NULL) {
+        while (oq_size(sim->waiting) > 0) {
+            free(oq_pop(sim->waiting, __builtin_ctz(sim->waiting->orders)));
+        }
+        oq_free(sim->waiting);
+    }
+    for (int i = 0; i < sim->node_count; i++) {
+        destroy_memory(sim->nodes[i].memory);
+    }
+    job_table_free(&sim->stats.jobs);
+
+    free(sim);
+}
@@ -0,0 +1,172 @@
+#ifndef SIM_ENGINE_H
+#define SIM_ENGINE_H
+
+#include <stdio.h>
+#include <limits.h>
+
+#include "process.h"
+#include "stats.h"
+#include "predictor.h"
+#include "io_device.h"
+#include "task_group.h"
+#include "admission.h"
+#include "Algorithms/utils.h"
+
+/**
+ * Library-mode simulation engine.
+ * Runs the scheduling policies, the buddy allocator and the statistics of os-sim as a
+ * single-threaded, deterministic discrete-event simulation: no fork, no clock process, no IPC.
+ * It can simulate several CPUs of different speeds sharing the ready queues: a CPU of speed 2
+ * does two ticks of a process's runtime per tick. The memory can be split into NUMA nodes,
+ * each with its own buddy allocator and share of the CPUs; a process runs slower on a CPU of
+ * another node than its memory. Processes that find no memory wait, and the admission policy
+ * picks which of them gets memory freed later; with a swap device, a blocked or less urgent
+ * process can be swapped out to make room and is swapped back in before it runs again.
+ *
+ * Usage:
+ *   SimConfig config;
+ *   sim_config_init(&config);
+ *   Sim* sim = sim_create(&config);
+ *   sim_submit(sim, &proc);              // any number of times, arrival_time >= current time
+ *   sim_run_until(sim, SIM_TIME_MAX);    // or step the simulation to a given time
+ *   const SimStats* stats = sim_stats(sim);
+ *   sim_destroy(sim);
+ */
+
+#define SIM_TIME_MAX INT_MAX
+#define SIM_MAX_CPUS 16
+#define SIM_MAX_NODES 8
+
+typedef enum SimAllocator {
+    SIM_ALLOC_BUDDY, // buddy system of memory_size, processes wait for memory
+    SIM_ALLOC_NONE   // unlimited memory, isolates the scheduling policy
+} SimAllocator;
+
+// Overhead charged to the CPU in simulated ticks, none by default
+typedef struct SimCosts {
+    int context_switch; // dispatching a process other than the one that ran last
+    int first_dispatch; // a process's first run, instead of the context switch cost
+    int migration;      // resuming on another CPU than the last run, the cache is cold there
+    int allocation;     // each memory allocation, paid by the next dispatch
+} SimCosts;
+
+// Where a process's memory goes (-N <nodes>,policy=<policy>)
+typedef enum NumaPolicy {
+    NUMA_LOCAL,     // home node first, then the other nodes, most free memory first
+    NUMA_STRICT,    // home node only, the process waits for memory there
+    NUMA_INTERLEAVE // the nodes in turn, whatever the home node
+} NumaPolicy;
+
+// Memory nodes: each has a buddy allocator of memory_size and an equal share of the CPUs
+typedef struct SimNuma {
+    int nodes;             // 1 (no NUMA) by default
+    NumaPolicy policy;
+    double remote_penalty; // a process runs this many times slower on a CPU of another node than its memory
+} SimNuma;
+
+// Swap device (-w <bandwidth>[,latency=<ticks>]): one transfer at a time, in FIFO order
+typedef struct SimSwap {
+    int bandwidth; // bytes a transfer moves per tick, 0 disables swapping
+    int latency;   // ticks every transfer takes on top of moving the bytes
+} SimSwap;
+
+typedef struct SimConfig {
+    SchedulingAlgorithm algorithm;
+    int quantum;     // RR, lottery and stride quantum
+    int memory_size; // buddy memory size (power of two)
+    SimAllocator allocator;
+    AdmissionMode admission; // EDF deadline admission control, ADMISSION_FLAG by default
+    int aging_interval;      // HPF: ticks of waiting per priority level gained, 0 disables aging
+    SimCosts costs;
+    double predict_alpha;     // srtn / sjf / hrrn order on predicted bursts, 0 uses the true runtime
+    PredictorKey predict_key; // classes sharing a burst history
+    uint64_t seed;            // device service times drawn from the device models
+    const IoDevice* io_devices; // device models, indexed by IoBurst.device, none by default
+    int io_device_count;
+    const TaskGroup* task_groups; // task group models, indexed by Process.group, only "default" by default
+    int task_group_count;
+    int cpu_count;                   // CPUs sharing the ready queues, 1 by default
+    double cpu_speed[SIM_MAX_CPUS];  // work units a CPU does per tick (big / little cores), 1 by default
+    SimNuma numa;                    // memory nodes, memory_size each
+    AdmitConfig admit;               // which waiting process gets freed memory, oldest first by default
+    SimSwap swap;                    // swap device, none by default
+
+    // Optional logs in the os-sim file formats, NULL disables them
+    FILE* scheduler_log;
+    FILE* memory_log;
+    FILE* execution_log;
+} SimConfig;
+
+typedef struct SimCpuStats {
+    double speed;
+    int busy_time;         // ticks spent running processes
+    long long work;        // work units done (busy ticks times the speed)
+    long long migrations;  // dispatches of a process that ran last on another CPU
+} SimCpuStats;
+
+typedef struct SimNodeStats {
+    int memory_size;
+    int cpu_count;
+    long long allocations;
+    long long fallbacks;   // allocations the policy placed here after another node had no block
+    long long local_time;  // ticks processes with memory on the node ran on its CPUs
+    long long remote_time; // ticks they ran on the CPUs of other nodes
+    double used_area;      // bytes in allocated blocks, integrated over time
+    double internal_area;  // bytes allocated blocks hold beyond their requests, integrated over time
+    double external_area;  // external fragmentation (1 - largest free block / free bytes), integrated over time
+} SimNodeStats;
+
+typedef struct SimSwapStats {
+    long long swap_outs;
+    long long swap_ins;
+    long long bytes_out;
+    long long bytes_in;
+    int busy_time;           // ticks the swap device was transferring
+    RunningStat out_time;    // ticks from the start of a swap-out to the end of the swap-in
+    RunningStat ta_swapped;  // TA of finished processes swapped out at least once
+    RunningStat ta_resident; // TA of the other finished processes
+} SimSwapStats;
+
+typedef struct SimStats {
+    long long submitted;
+    long long finished;
+    long long rejected; // refused by admission control
+    long long events; // arrival and run-end events processed
+    int current_time; // earliest time not simulated yet
+    int end_time;     // time the last process finished
+    int busy_time;    // CPU time spent running processes
+    int idle_time;    // CPU idle gaps while processes were in the system, summed over the CPUs
+    int overhead_time;          // CPU time spent on switches, dispatches and allocations
+    long long context_switches; // dispatches of a process other than the one that ran last
+    PerfStats perf;
+    JobTable jobs;    // finished processes, for the scheduler.perf breakdowns
+    Predictor predictor; // runtime prediction state and its error statistics
+    IoStats io;          // device utilization and CPU / I/O overlap
+    TaskGroupStats* groups; // per task group CPU share, throttling and latency
+    int group_count;
+    int cpu_count;
+    SimCpuStats cpu[SIM_MAX_CPUS];
+    int node_count;
+    SimNodeStats node[SIM_MAX_NODES];
+    MemoryStats memory; // memory in use over all nodes and the wait for memory
+    SimSwapStats swap;
+} SimStats;
+
+typedef struct Sim Sim;
+
+void sim_config_init(SimConfig* config);
+int parse_allocator(const char* name, SimAllocator* allocator);
+const char* allocator_name(SimAllocator allocator);
+int parse_costs(const char* spec, SimCosts* costs);
+int parse_cpus(const char* spec, SimConfig* config);
+int parse_numa(const char* spec, SimNuma* numa);
+const char* numa_policy_name(NumaPolicy policy);
+int parse_swap(const char* spec, SimSwap* swap);
+Sim* sim_create(const SimConfig* config);
+int sim_submit(Sim* sim, const Process* proc);
+long long sim_run_until(Sim* sim, int time);
+int sim_run_trace(Sim* sim, const Process* processes, int count);
+const SimStats* sim_stats(Sim* sim);
+void sim_destroy(Sim* sim);
+
+#endif /* SIM_ENGINE_H */
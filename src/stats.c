@@ -0,0 +1,486 @@
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stats.h"
+
+/**
+ * @brief Reset a running statistic
+ *
+ * @param[in] stat pointer to the statistic
+ */
+void running_stat_init(RunningStat* stat) {
+    stat->count = 0;
+    stat->mean = 0;
+    stat->m2 = 0;
+    stat->min = 0;
+    stat->max = 0;
+}
+
+/**
+ * @brief Add one sample using Welford's update (numerically stable, single pass)
+ *
+ * @param[in] stat pointer to the statistic
+ * @param[in] value sample to add
+ */
+void running_stat_push(RunningStat* stat, double value) {
+    stat->count++;
+
+    if (stat->count == 1) {
+        stat->min = value;
+        stat->max = value;
+    }
+    else {
+        if (value < stat->min) stat->min = value;
+        if (value > stat->max) stat->max = value;
+    }
+
+    double delta = value - stat->mean;
+    stat->mean += delta / stat->count;
+    stat->m2 += delta * (value - stat->mean);
+}
+
+/**
+ * @brief Population variance of the samples pushed so far
+ */
+double running_stat_variance(const RunningStat* stat) {
+    if (stat->count == 0) {
+        return 0;
+    }
+    return stat->m2 / stat->count;
+}
+
+/**
+ * @brief Population standard deviation of the samples pushed so far
+ */
+double running_stat_stddev(const RunningStat* stat) {
+    return sqrt(running_stat_variance(stat));
+}
+
+/**
+ * @brief Map a value (in histogram units) to its bucket index
+ * @details Values below 2 * HIST_SUB_BUCKET_COUNT get one bucket each,
+ *          every following power of two is split into HIST_SUB_BUCKET_COUNT buckets.
+ */
+static int histogram_index(long long value) {
+    if (value < 0) {
+        value = 0;
+    }
+    if (value >= (1LL << HIST_MAX_MAGNITUDE)) {
+        value = (1LL << HIST_MAX_MAGNITUDE) - 1;
+    }
+    if (value < 2 * HIST_SUB_BUCKET_COUNT) {
+        return (int)value;
+    }
+
+    int msb = 63 - __builtin_clzll((unsigned long long)value);
+    int shift = msb - HIST_SUB_BUCKET_BITS;
+
+    return (shift + 1) * HIST_SUB_BUCKET_COUNT + (int)((value >> shift) - HIST_SUB_BUCKET_COUNT);
+}
+
+/**
+ * @brief Representative value (in histogram units) of a bucket, the middle of its range
+ */
+static double histogram_bucket_value(int index) {
+    if (index < 2 * HIST_SUB_BUCKET_COUNT) {
+        return index;
+    }
+
+    int shift = index / HIST_SUB_BUCKET_COUNT - 1;
+    long long sub_bucket = index % HIST_SUB_BUCKET_COUNT + HIST_SUB_BUCKET_COUNT;
+    long long lowest = sub_bucket << shift;
+    long long width = 1LL << shift;
+
+    return lowest + (width - 1) / 2.0;
+}
+
+/**
+ * @brief Reset a histogram
+ *
+ * @param[in] hist pointer to the histogram
+ * @param[in] unit resolution of the recorded values
+ */
+void histogram_init(Histogram* hist, double unit) {
+    memset(hist, 0, sizeof(Histogram));
+    hist->unit = unit;
+}
+
+/**
+ * @brief Record one value in the histogram
+ */
+void histogram_record(Histogram* hist, double value) {
+    long long scaled = (long long)(value / hist->unit + 0.5);
+    hist->counts[histogram_index(scaled)]++;
+    hist->total++;
+}
+
+/**
+ * @brief Get the value at a given percentile
+ *
+ * @param[in] hist pointer to the histogram
+ * @param[in] percentile percentile in the range [0, 100]
+ *
+ * @return double the percentile value, 0 if the histogram is empty
+ */
+double histogram_percentile(const Histogram* hist, double percentile) {
+    if (hist->total == 0) {
+        return 0;
+    }
+
+    long long rank = (long long)ceil(percentile / 100.0 * hist->total);
+    if (rank < 1) rank = 1;
+    if (rank > hist->total) rank = hist->total;
+
+    long long seen = 0;
+    for (int i = 0; i < HIST_BUCKET_COUNT; i++) {
+        seen += hist->counts[i];
+        if (seen >= rank) {
+            return histogram_bucket_value(i) * hist->unit;
+        }
+    }
+
+    return histogram_bucket_value(HIST_BUCKET_COUNT - 1) * hist->unit;
+}
+
+/**
+ * @brief Reset all performance accumulators
+ */
+void perf_stats_init(PerfStats* stats) {
+    running_stat_init(&stats->ta);
+    running_stat_init(&stats->wta);
+    running_stat_init(&stats->wait);
+    running_stat_init(&stats->response);
+
+    histogram_init(&stats->ta_hist, 1);
+    histogram_init(&stats->wta_hist, 0.001);
+    histogram_init(&stats->wait_hist, 1);
+    histogram_init(&stats->response_hist, 1);
+}
+
+/**
+ * @brief Record the metrics of one finished process
+ *
+ * @param[in] ta turnaround time
+ * @param[in] wta weighted turnaround time
+ * @param[in] wait total waiting time
+ * @param[in] response time from arrival to first run
+ */
+void perf_stats_record(PerfStats* stats, int ta, double wta, int wait, int response) {
+    running_stat_push(&stats->ta, ta);
+    running_stat_push(&stats->wta, wta);
+    running_stat_push(&stats->wait, wait);
+    running_stat_push(&stats->response, response);
+
+    histogram_record(&stats->ta_hist, ta);
+    histogram_record(&stats->wta_hist, wta);
+    histogram_record(&stats->wait_hist, wait);
+    histogram_record(&stats->response_hist, response);
+}
+
+/**
+ * @brief Initialize an empty job table
+ */
+void job_table_init(JobTable* table) {
+    memset(table, 0, sizeof(JobTable));
+}
+
+static int grow_column(int** column, long long capacity) {
+    int* grown = realloc(*column, capacity * sizeof(int));
+    if (grown == NULL) {
+        return 1;
+    }
+    *column = grown;
+    return 0;
+}
+
+static int grow_double_column(double** column, long long capacity) {
+    double* grown = realloc(*column, capacity * sizeof(double));
+    if (grown == NULL) {
+        return 1;
+    }
+    *column = grown;
+    return 0;
+}
+
+/**
+ * @brief Append one finished process to the job table
+ *
+ * @return int 0 for success, 1 if the table could not grow
+ */
+int job_table_push(JobTable* table, int arrival, int start, int finish, int runtime, int wait, int priority, int memory_size,
+    int deadline, double intended) {
+    if (table->count == table->capacity) {
+        long long capacity = table->capacity > 0 ? 2 * table->capacity : 256;
+        if (grow_column(&table->arrival, capacity) || grow_column(&table->start, capacity) ||
+            grow_column(&table->finish, capacity) || grow_column(&table->runtime, capacity) ||
+            grow_column(&table->wait, capacity) || grow_column(&table->priority, capacity) ||
+            grow_column(&table->memory_size, capacity) || grow_column(&table->deadline, capacity) ||
+            grow_double_column(&table->intended, capacity)) {
+            return 1;
+        }
+        table->capacity = capacity;
+    }
+
+    long long i = table->count++;
+    table->arrival[i] = arrival;
+    table->start[i] = start;
+    table->finish[i] = finish;
+    table->runtime[i] = runtime;
+    table->wait[i] = wait;
+    table->priority[i] = priority;
+    table->memory_size[i] = memory_size;
+    table->deadline[i] = deadline;
+    table->intended[i] = intended;
+    return 0;
+}
+
+/**
+ * @brief Release the columns of a job table
+ */
+void job_table_free(JobTable* table) {
+    free(table->arrival);
+    free(table->start);
+    free(table->finish);
+    free(table->runtime);
+    free(table->wait);
+    free(table->priority);
+    free(table->memory_size);
+    free(table->deadline);
+    free(table->intended);
+    job_table_init(table);
+}
+
+/**
+ * @brief Size class of a memory size: floor(log2(size)), clamped to JOB_SIZE_CLASSES - 1
+ */
+int job_size_class(int memory_size) {
+    if (memory_size <= 1) {
+        return 0;
+    }
+    int size_class = 31 - __builtin_clz((unsigned int)memory_size);
+    return size_class < JOB_SIZE_CLASSES ? size_class : JOB_SIZE_CLASSES - 1;
+}
+
+static void job_group_add(JobGroup* group, int ta, double wta, int wait, int response, int runtime, double intended) {
+    group->count++;
+    group->runtime_sum += runtime;
+    group->intended_sum += intended;
+    group->ta_sum += ta;
+    group->wta_sum += wta;
+    group->wait_sum += wait;
+    group->response_sum += response;
+    if (wait > group->wait_max) {
+        group->wait_max = wait;
+    }
+}
+
+#define JOB_BLOCK 512 // jobs per block, keeps the block temporaries in L1
+
+/**
+ * @brief Compute the totals, WTA spread, deadline misses, share ratios and per-priority / per-size breakdowns in one pass
+ * @details The table is walked in blocks: the derived TA / WTA / response columns of a block
+ *          are computed and reduced with branch-free loops the compiler vectorizes, block
+ *          variances are merged with Chan's formula, and only the group scatter is scalar.
+ *
+ * @param[in] table finished processes
+ * @param[out] summary metrics of the table
+ */
+void job_table_summarize(const JobTable* table, JobSummary* summary) {
+    int ta[JOB_BLOCK];
+    int response[JOB_BLOCK];
+    double wta[JOB_BLOCK];
+
+    memset(summary, 0, sizeof(JobSummary));
+    summary->lateness_max = INT_MIN;
+    double wta_mean = 0;
+
+    for (long long base = 0; base < table->count; base += JOB_BLOCK) {
+        int n = table->count - base < JOB_BLOCK ? (int)(table->count - base) : JOB_BLOCK;
+        const int* arrival = table->arrival + base;
+        const int* start = table->start + base;
+        const int* finish = table->finish + base;
+        const int* runtime = table->runtime + base;
+        const int* wait = table->wait + base;
+
+        double ta_sum = 0, wta_sum = 0, wait_sum = 0, response_sum = 0;
+#pragma omp simd reduction(+:ta_sum, wta_sum, wait_sum, response_sum)
+        for (int i = 0; i < n; i++) {
+            ta[i] = finish[i] - arrival[i];
+            response[i] = start[i] - arrival[i];
+            wta[i] = (double)ta[i] / runtime[i];
+            ta_sum += ta[i];
+            wta_sum += wta[i];
+            wait_sum += wait[i];
+            response_sum += response[i];
+        }
+
+        double block_mean = wta_sum / n;
+        double block_m2 = 0;
+#pragma omp simd reduction(+:block_m2)
+        for (int i = 0; i < n; i++) {
+            double delta = wta[i] - block_mean;
+            block_m2 += delta * delta;
+        }
+
+        // Chan et al. pairwise merge of (count, mean, m2)
+        long long count = summary->all.count;
+        double delta = block_mean - wta_mean;
+        summary->wta_m2 += block_m2 + delta * delta * ((double)count * n / (count + n));
+        wta_mean += delta * n / (count + n);
+
+        summary->all.count += n;
+        summary->all.ta_sum += ta_sum;
+        summary->all.wta_sum += wta_sum;
+        summary->all.wait_sum += wait_sum;
+        summary->all.response_sum += response_sum;
+
+        const int* deadline = table->deadline + base;
+        long long deadline_count = 0, missed = 0;
+        double lateness_sum = 0;
+        int lateness_max = INT_MIN;
+#pragma omp simd reduction(+:deadline_count, missed, lateness_sum) reduction(max:lateness_max)
+        for (int i = 0; i < n; i++) {
+            int has_deadline = deadline[i] > 0;
+            int lateness = finish[i] - deadline[i];
+            deadline_count += has_deadline;
+            missed += has_deadline & (lateness > 0);
+            lateness_sum += has_deadline ? lateness : 0;
+            int masked = has_deadline ? lateness : INT_MIN;
+            lateness_max = masked > lateness_max ? masked : lateness_max;
+        }
+        summary->deadline_count += deadline_count;
+        summary->missed += missed;
+        summary->lateness_sum += lateness_sum;
+        if (lateness_max > summary->lateness_max) {
+            summary->lateness_max = lateness_max;
+        }
+
+        const double* intended = table->intended + base;
+        long long share_count = 0;
+        double share_sum = 0, share_sq_sum = 0;
+#pragma omp simd reduction(+:share_count, share_sum, share_sq_sum)
+        for (int i = 0; i < n; i++) {
+            int tracked = intended[i] > 0;
+            double ratio = tracked ? runtime[i] / intended[i] : 0;
+            share_count += tracked;
+            share_sum += ratio;
+            share_sq_sum += ratio * ratio;
+        }
+        summary->share_count += share_count;
+        summary->share_sum += share_sum;
+        summary->share_sq_sum += share_sq_sum;
+
+        const int* priority = table->priority + base;
+        const int* memory_size = table->memory_size + base;
+        for (int i = 0; i < n; i++) {
+            int priority_class = priority[i] < 0 ? 0 : priority[i];
+            if (priority_class >= JOB_PRIORITY_CLASSES) {
+                priority_class = JOB_PRIORITY_CLASSES - 1;
+            }
+            job_group_add(&summary->by_priority[priority_class], ta[i], wta[i], wait[i], response[i], runtime[i], intended[i]);
+            job_group_add(&summary->by_size[job_size_class(memory_size[i])], ta[i], wta[i], wait[i], response[i],
+                runtime[i], intended[i]);
+        }
+    }
+}
+
+/**
+ * @brief Jain's fairness index of the achieved / intended CPU time ratios
+ * @details (sum x)^2 / (n * sum x^2): 1 when every process got the same fraction of its
+ *          entitlement, down to 1/n when one process got everything.
+ *
+ * @return double the index, 0 when no process had an intended share
+ */
+double job_summary_jain_index(const JobSummary* summary) {
+    if (summary->share_count == 0 || summary->share_sq_sum <= 0) {
+        return 0;
+    }
+    return summary->share_sum * summary->share_sum / (summary->share_count * summary->share_sq_sum);
+}
+
+/**
+ * @brief Jain's fairness index of the achieved / intended CPU time ratios of the priority
+ *        (ticket) classes
+ * @details Short processes live a few quanta, so their own ratio mostly measures quantum
+ *          granularity against the fluid entitlement; the class totals average it out.
+ *
+ * @return double the index, 0 when no process had an intended share
+ */
+double job_summary_class_jain_index(const JobSummary* summary) {
+    int count = 0;
+    double sum = 0, sq_sum = 0;
+    for (int i = 0; i < JOB_PRIORITY_CLASSES; i++) {
+        const JobGroup* group = &summary->by_priority[i];
+        if (group->intended_sum > 0) {
+            double ratio = group->runtime_sum / group->intended_sum;
+            count++;
+            sum += ratio;
+            sq_sum += ratio * ratio;
+        }
+    }
+    return count > 0 && sq_sum > 0 ? sum * sum / (count * sq_sum) : 0;
+}
+
+void timeline_init(Timeline* timeline) {
+    memset(timeline, 0, sizeof(Timeline));
+    timeline->width = 1;
+}
+
+/**
+ * @brief Integrate the current value up to `time`, then hold `value` from `time` on
+ */
+void timeline_set(Timeline* timeline, int time, double value) {
+    while ((long long)timeline->width * TIMELINE_BUCKETS < time) {
+        for (int i = 0; i < TIMELINE_BUCKETS / 2; i++) {
+            timeline->area[i] = timeline->area[2 * i] + timeline->area[2 * i + 1];
+        }
+        for (int i = TIMELINE_BUCKETS / 2; i < TIMELINE_BUCKETS; i++) {
+            timeline->area[i] = 0;
+        }
+        timeline->width *= 2;
+    }
+
+    while (timeline->changed_at < time) {
+        int bucket = timeline->changed_at / timeline->width;
+        int end = (bucket + 1) * timeline->width < time ? (bucket + 1) * timeline->width : time;
+        timeline->area[bucket] += timeline->value * (end - timeline->changed_at);
+        timeline->changed_at = end;
+    }
+    timeline->value = value;
+    timeline->max = value > timeline->max ? value : timeline->max;
+}
+
+/**
+ * @brief Number of buckets a run ending at `end_time` covers
+ */
+int timeline_buckets(const Timeline* timeline, int end_time) {
+    int buckets = (end_time + timeline->width - 1) / timeline->width;
+    return buckets < TIMELINE_BUCKETS ? buckets : TIMELINE_BUCKETS;
+}
+
+/**
+ * @brief Average value over a bucket, the last one ends at `end_time`
+ * @details Only exact when the timeline was brought up to `end_time` with timeline_set.
+ */
+double timeline_mean(const Timeline* timeline, int bucket, int end_time) {
+    int start = bucket * timeline->width;
+    int end = start + timeline->width < end_time ? start + timeline->width : end_time;
+    return end > start ? timeline->area[bucket] / (end - start) : 0;
+}
+
+void memory_stats_init(MemoryStats* stats) {
+    timeline_init(&stats->used);
+    for (int i = 0; i < JOB_SIZE_CLASSES; i++) {
+        running_stat_init(&stats->wait[i]);
+    }
+    stats->waited = 0;
+}
+
+/**
+ * @brief Record a process that got its memory at `time`
+ */
+void memory_stats_admit(MemoryStats* stats, int memory_size, int arrival, int time) {
+    running_stat_push(&stats->wait[job_size_class(memory_size)], time - arrival);
+}
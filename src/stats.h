@@ -0,0 +1,147 @@
+#ifndef STATS_H
+#define STATS_H
+
+/**
+ * Statistics used by scheduler.perf.
+ * The streaming accumulators are single-pass and fixed-size; the job table keeps one
+ * column entry per finished process for the end-of-run breakdowns.
+ */
+
+// Histogram layout: values below 2^(HIST_SUB_BUCKET_BITS + 1) units are recorded exactly,
+// larger values keep HIST_SUB_BUCKET_BITS bits of precision (< 1% relative error)
+#define HIST_SUB_BUCKET_BITS 7
+#define HIST_SUB_BUCKET_COUNT (1 << HIST_SUB_BUCKET_BITS)
+#define HIST_MAX_MAGNITUDE 40 // largest recordable value is 2^40 units
+#define HIST_BUCKET_COUNT ((HIST_MAX_MAGNITUDE - HIST_SUB_BUCKET_BITS + 1) * HIST_SUB_BUCKET_COUNT)
+
+// Welford running mean / variance
+typedef struct RunningStat {
+    long long count;
+    double mean;
+    double m2; // sum of squared differences from the mean
+    double min;
+    double max;
+} RunningStat;
+
+// HDR-style log-linear histogram
+typedef struct Histogram {
+    double unit;      // resolution of the recorded values (e.g. 1 tick, 0.001 WTA)
+    long long total;  // number of recorded values
+    long long counts[HIST_BUCKET_COUNT];
+} Histogram;
+
+// Per-metric accumulators for finished processes
+typedef struct PerfStats {
+    RunningStat ta;
+    RunningStat wta;
+    RunningStat wait;
+    RunningStat response;
+
+    Histogram ta_hist;
+    Histogram wta_hist;
+    Histogram wait_hist;
+    Histogram response_hist;
+} PerfStats;
+
+// Columnar (struct-of-arrays) table of finished processes, one int per column per job
+typedef struct JobTable {
+    long long count;
+    long long capacity;
+    int* arrival;
+    int* start;
+    int* finish;
+    int* runtime;
+    int* wait;
+    int* priority;
+    int* memory_size;
+    int* deadline; // absolute, 0 for none
+    double* intended; // CPU time the process was entitled to under proportional share, 0 when not tracked
+
+    // Admission control decisions (EDF), rejected processes never reach the table
+    long long flagged;
+    long long rejected;
+} JobTable;
+
+#define JOB_PRIORITY_CLASSES 11 // priorities 0..9 and 10+
+#define JOB_SIZE_CLASSES 10     // memory sizes 1, 2-3, 4-7, ..., 256-511, 512+
+#define TIMELINE_BUCKETS 20
+
+// Sums of one group of finished processes
+typedef struct JobGroup {
+    long long count;
+    double ta_sum;
+    double wta_sum;
+    double wait_sum;
+    double response_sum;
+    int wait_max;
+    double runtime_sum;
+    double intended_sum;
+} JobGroup;
+
+// End-of-run metrics of a job table
+typedef struct JobSummary {
+    JobGroup all;
+    double wta_m2; // sum of squared differences from the mean WTA
+
+    // Processes with a deadline; lateness = finish - deadline
+    long long deadline_count;
+    long long missed;
+    double lateness_sum;
+    int lateness_max;
+
+    // Processes with an intended share; ratio = runtime / intended CPU time
+    long long share_count;
+    double share_sum;
+    double share_sq_sum;
+
+    JobGroup by_priority[JOB_PRIORITY_CLASSES];
+    JobGroup by_size[JOB_SIZE_CLASSES];
+} JobSummary;
+
+// Time-weighted average of a value per bucket of time; when the run outgrows the buckets
+// their width doubles and neighbouring buckets merge, so a run keeps 10 to 20 of them
+typedef struct Timeline {
+    double area[TIMELINE_BUCKETS]; // the value integrated over each bucket
+    int width;      // ticks per bucket
+    double value;   // current value
+    double max;     // highest value held
+    int changed_at; // the buckets are exact up to this time
+} Timeline;
+
+// Memory admission: memory in use over time and the wait for memory per size class
+typedef struct MemoryStats {
+    Timeline used;                      // bytes in allocated blocks
+    RunningStat wait[JOB_SIZE_CLASSES]; // ticks from arrival to getting memory
+    long long waited;                   // processes queued for memory on arrival
+} MemoryStats;
+
+void running_stat_init(RunningStat* stat);
+void running_stat_push(RunningStat* stat, double value);
+double running_stat_variance(const RunningStat* stat);
+double running_stat_stddev(const RunningStat* stat);
+
+void histogram_init(Histogram* hist, double unit);
+void histogram_record(Histogram* hist, double value);
+double histogram_percentile(const Histogram* hist, double percentile);
+
+void perf_stats_init(PerfStats* stats);
+void perf_stats_record(PerfStats* stats, int ta, double wta, int wait, int response);
+
+void job_table_init(JobTable* table);
+int job_table_push(JobTable* table, int arrival, int start, int finish, int runtime, int wait, int priority, int memory_size,
+    int deadline, double intended);
+void job_table_free(JobTable* table);
+void job_table_summarize(const JobTable* table, JobSummary* summary);
+int job_size_class(int memory_size);
+double job_summary_jain_index(const JobSummary* summary);
+double job_summary_class_jain_index(const JobSummary* summary);
+
+void timeline_init(Timeline* timeline);
+void timeline_set(Timeline* timeline, int time, double value);
+int timeline_buckets(const Timeline* timeline, int end_time);
+double timeline_mean(const Timeline* timeline, int bucket, int end_time);
+
+void memory_stats_init(MemoryStats* stats);
+void memory_stats_admit(MemoryStats* stats, int memory_size, int arrival, int time);
+
+#endif /* STATS_H */
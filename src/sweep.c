@@ -0,0 +1,388 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "sweep.h"
+#include "stats.h"
+#include "Algorithms/policy.h"
+
+// scheduler.perf metrics of one configuration
+typedef struct SweepResult {
+    SimConfig config;
+    int status;    // 0 ok, 1 invalid configuration or a run that failed
+    int rejected;  // processes the configuration could not run
+    long long finished;
+    int end_time;
+    double cpu_utilization;
+    int overhead;
+    double effective_utilization; // CPU utilization without the overhead
+    double avg_ta, avg_wta, std_wta, avg_wait;
+    double ta_p[4], wta_p[4], wait_p[4], response_p[4];
+    double run_ms; // wall time of the simulation
+} SweepResult;
+
+typedef struct SweepJob {
+    SweepResult* results;
+    int count;
+    int next; // next configuration to run, taken atomically by the workers
+    const Process* processes;
+    int process_count;
+} SweepJob;
+
+static const double sweep_percentiles[4] = { 50, 90, 99, 99.9 };
+
+/**
+ * @brief Count the comma separated items of a list
+ */
+static int list_count(const char* list) {
+    int count = 1;
+    for (const char* c = list; *c; c++) {
+        count += (*c == ',');
+    }
+    return count;
+}
+
+/**
+ * @brief Parse "1,2,4" or ranges such as "1-8" into a newly allocated int array
+ *
+ * @return int number of values, -1 on error
+ */
+static int parse_int_list(const char* list, int** values) {
+    int capacity = 16;
+    int count = 0;
+    *values = malloc(capacity * sizeof(int));
+
+    char* copy = strdup(list);
+    char* save = NULL;
+    for (char* item = strtok_r(copy, ",", &save); item != NULL; item = strtok_r(NULL, ",", &save)) {
+        int low, high;
+        char extra;
+        if (sscanf(item, "%d-%d%c", &low, &high, &extra) == 2) {
+            if (high < low) {
+                count = -1;
+                break;
+            }
+        }
+        else if (sscanf(item, "%d%c", &low, &extra) == 1) {
+            high = low;
+        }
+        else {
+            count = -1;
+            break;
+        }
+
+        for (int v = low; v <= high; v++) {
+            if (count == capacity) {
+                capacity *= 2;
+                *values = realloc(*values, capacity * sizeof(int));
+            }
+            (*values)[count++] = v;
+        }
+    }
+    free(copy);
+
+    if (count <= 0) {
+        free(*values);
+        *values = NULL;
+        return -1;
+    }
+    return count;
+}
+
+/**
+ * @brief Parse the grid axes, each a comma separated list
+ *
+ * @return int 0 for success, 1 for error
+ */
+int sweep_parse_grid(SweepGrid* grid, const char* algorithms, const char* quanta,
+    const char* memory_sizes, const char* allocators) {
+    memset(grid, 0, sizeof(SweepGrid));
+    grid->admission = ADMISSION_FLAG;
+
+    grid->algorithms = malloc(list_count(algorithms) * sizeof(SchedulingAlgorithm));
+    grid->allocators = malloc(list_count(allocators) * sizeof(SimAllocator));
+
+    char* copy = strdup(algorithms);
+    char* save = NULL;
+    for (char* item = strtok_r(copy, ",", &save); item != NULL; item = strtok_r(NULL, ",", &save)) {
+        if (parse_algorithm(item, &grid->algorithms[grid->algorithm_count++]) != 0) {
+            fprintf(stderr, "Sweep: unknown algorithm %s\n", item);
+            free(copy);
+            return 1;
+        }
+    }
+    free(copy);
+
+    copy = strdup(allocators);
+    for (char* item = strtok_r(copy, ",", &save); item != NULL; item = strtok_r(NULL, ",", &save)) {
+        if (parse_allocator(item, &grid->allocators[grid->allocator_count++]) != 0) {
+            fprintf(stderr, "Sweep: unknown allocator %s\n", item);
+            free(copy);
+            return 1;
+        }
+    }
+    free(copy);
+
+    grid->quantum_count = parse_int_list(quanta, &grid->quanta);
+    grid->memory_size_count = parse_int_list(memory_sizes, &grid->memory_sizes);
+    if (grid->quantum_count < 0 || grid->memory_size_count < 0 || grid->algorithm_count == 0 || grid->allocator_count == 0) {
+        fprintf(stderr, "Sweep: invalid quantum or memory size list\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+void sweep_free_grid(SweepGrid* grid) {
+    free(grid->algorithms);
+    free(grid->quanta);
+    free(grid->memory_sizes);
+    free(grid->allocators);
+    memset(grid, 0, sizeof(SweepGrid));
+}
+
+/**
+ * @brief Expand the grid into configurations
+ * @details Axes that do not affect a configuration (quantum for non-quantum policies,
+ *          memory size without an allocator) are not expanded and reported as 0.
+ *
+ * @return int number of configurations written to `results`
+ */
+static int expand_grid(const SweepGrid* grid, SweepResult* results) {
+    int count = 0;
+    for (int a = 0; a < grid->algorithm_count; a++) {
+        int quantum_count = policy_uses_quantum(grid->algorithms[a]) ? grid->quantum_count : 1;
+        for (int q = 0; q < quantum_count; q++) {
+            for (int l = 0; l < grid->allocator_count; l++) {
+                int memory_count = grid->allocators[l] == SIM_ALLOC_NONE ? 1 : grid->memory_size_count;
+                for (int m = 0; m < memory_count; m++) {
+                    SweepResult* result = &results[count++];
+                    memset(result, 0, sizeof(SweepResult));
+                    sim_config_init(&result->config);
+                    result->config.algorithm = grid->algorithms[a];
+                    result->config.quantum = policy_uses_quantum(grid->algorithms[a]) ? grid->quanta[q] : 0;
+                    result->config.allocator = grid->allocators[l];
+                    result->config.memory_size = grid->allocators[l] == SIM_ALLOC_NONE ? 0 : grid->memory_sizes[m];
+                    result->config.costs = grid->costs;
+                    result->config.admit = grid->admit;
+                    result->config.swap = grid->swap;
+                    result->config.admission = grid->admission;
+                    result->config.aging_interval = grid->aging_interval;
+                    if (grid->cpu_count > 0) {
+                        result->config.cpu_count = grid->cpu_count;
+                        memcpy(result->config.cpu_speed, grid->cpu_speed, sizeof(grid->cpu_speed));
+                    }
+                    if (grid->numa.nodes > 0) {
+                        result->config.numa = grid->numa;
+                    }
+                    result->config.predict_alpha = grid->predict_alpha;
+                    result->config.predict_key = grid->predict_key;
+                    result->config.io_devices = grid->io_devices;
+                    result->config.io_device_count = grid->io_device_count;
+                    result->config.task_groups = grid->task_groups;
+                    result->config.task_group_count = grid->task_group_count;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Run one configuration and fill its metrics
+ */
+static void sweep_run_one(SweepResult* result, const Process* processes, int process_count) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    SimConfig config = result->config;
+    if (config.quantum == 0) config.quantum = 1;
+    if (config.memory_size == 0) config.memory_size = MAX_SIZE;
+
+    Sim* sim = sim_create(&config);
+    if (sim == NULL) {
+        result->status = 1;
+        return;
+    }
+
+    result->rejected = sim_run_trace(sim, processes, process_count);
+    if (result->rejected < 0) {
+        sim_destroy(sim);
+        result->status = 1;
+        return;
+    }
+
+    const SimStats* stats = sim_stats(sim);
+    const PerfStats* perf = &stats->perf;
+    result->rejected += (int)stats->rejected; // and refused by EDF admission control
+    result->finished = stats->finished;
+    result->end_time = stats->end_time;
+    double capacity = (double)stats->end_time * stats->cpu_count; // CPU ticks of all CPUs
+    result->cpu_utilization = capacity > 0 ? (1 - stats->idle_time / capacity) * 100 : 0;
+    result->overhead = stats->overhead_time;
+    result->effective_utilization = capacity > 0 ?
+        (1 - (stats->idle_time + stats->overhead_time) / capacity) * 100 : 0;
+    result->avg_ta = perf->ta.mean;
+    result->avg_wta = perf->wta.mean;
+    result->std_wta = running_stat_stddev(&perf->wta);
+    result->avg_wait = perf->wait.mean;
+    for (int i = 0; i < 4; i++) {
+        result->ta_p[i] = histogram_percentile(&perf->ta_hist, sweep_percentiles[i]);
+        result->wta_p[i] = histogram_percentile(&perf->wta_hist, sweep_percentiles[i]);
+        result->wait_p[i] = histogram_percentile(&perf->wait_hist, sweep_percentiles[i]);
+        result->response_p[i] = histogram_percentile(&perf->response_hist, sweep_percentiles[i]);
+    }
+    sim_destroy(sim);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    result->run_ms = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+/**
+ * @brief Worker thread: take configurations until none are left
+ */
+static void* sweep_worker(void* arg) {
+    SweepJob* job = (SweepJob*)arg;
+    while (1) {
+        int index = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (index >= job->count) {
+            return NULL;
+        }
+        sweep_run_one(&job->results[index], job->processes, job->process_count);
+    }
+}
+
+static void write_csv(FILE* out, const SweepResult* results, int count) {
+    static const char* metrics[] = { "ta", "wta", "wait", "response" };
+    static const char* labels[] = { "p50", "p90", "p99", "p999" };
+
+    fprintf(out, "algorithm,quantum,memory_size,allocator,finished,rejected,end_time,cpu_utilization,overhead,effective_utilization,"
+        "avg_ta,avg_wta,std_wta,avg_wait");
+    for (int m = 0; m < 4; m++) {
+        for (int p = 0; p < 4; p++) {
+            fprintf(out, ",%s_%s", metrics[m], labels[p]);
+        }
+    }
+    fprintf(out, ",run_ms\n");
+
+    for (int i = 0; i < count; i++) {
+        const SweepResult* r = &results[i];
+        if (r->status != 0) {
+            continue;
+        }
+        fprintf(out, "%s,%d,%d,%s,%lld,%d,%d,%.4f,%d,%.4f,%.4f,%.4f,%.4f,%.4f",
+            algorithm_name(r->config.algorithm), r->config.quantum, r->config.memory_size,
+            allocator_name(r->config.allocator), r->finished, r->rejected, r->end_time,
+            r->cpu_utilization, r->overhead, r->effective_utilization, r->avg_ta, r->avg_wta, r->std_wta, r->avg_wait);
+        const double* values[] = { r->ta_p, r->wta_p, r->wait_p, r->response_p };
+        for (int m = 0; m < 4; m++) {
+            for (int p = 0; p < 4; p++) {
+                fprintf(out, ",%.4f", values[m][p]);
+            }
+        }
+        fprintf(out, ",%.3f\n", r->run_ms);
+    }
+}
+
+static void write_json(FILE* out, const SweepResult* results, int count) {
+    static const char* metrics[] = { "ta", "wta", "wait", "response" };
+    static const char* labels[] = { "p50", "p90", "p99", "p999" };
+
+    for (int i = 0; i < count; i++) {
+        const SweepResult* r = &results[i];
+        if (r->status != 0) {
+            continue;
+        }
+        fprintf(out, "{\"algorithm\":\"%s\",\"quantum\":%d,\"memory_size\":%d,\"allocator\":\"%s\","
+            "\"finished\":%lld,\"rejected\":%d,\"end_time\":%d,\"cpu_utilization\":%.4f,"
+            "\"overhead\":%d,\"effective_utilization\":%.4f,"
+            "\"avg_ta\":%.4f,\"avg_wta\":%.4f,\"std_wta\":%.4f,\"avg_wait\":%.4f",
+            algorithm_name(r->config.algorithm), r->config.quantum, r->config.memory_size,
+            allocator_name(r->config.allocator), r->finished, r->rejected, r->end_time,
+            r->cpu_utilization, r->overhead, r->effective_utilization, r->avg_ta, r->avg_wta, r->std_wta, r->avg_wait);
+        const double* values[] = { r->ta_p, r->wta_p, r->wait_p, r->response_p };
+        for (int m = 0; m < 4; m++) {
+            for (int p = 0; p < 4; p++) {
+                fprintf(out, ",\"%s_%s\":%.4f", metrics[m], labels[p], values[m][p]);
+            }
+        }
+        fprintf(out, ",\"run_ms\":%.3f}\n", r->run_ms);
+    }
+}
+
+/**
+ * @brief Run every configuration of the grid and write the results
+ *
+ * @param[in] grid the parameter grid
+ * @param[in] processes the workload, sorted by arrival time
+ * @param[in] process_count number of processes
+ * @param[in] threads worker threads, 0 uses every online core
+ * @param[in] output CSV file, or JSON lines when the name ends in ".json"
+ *
+ * @return int 0 for success, 1 for error
+ */
+int run_sweep(const SweepGrid* grid, const Process* processes, int process_count, int threads, const char* output) {
+    int max_count = grid->algorithm_count * grid->quantum_count * grid->memory_size_count * grid->allocator_count;
+    SweepResult* results = malloc(max_count * sizeof(SweepResult));
+    if (results == NULL) {
+        perror("Sweep: failed to allocate results");
+        return 1;
+    }
+
+    SweepJob job = { results, expand_grid(grid, results), 0, processes, process_count };
+
+    if (threads <= 0) {
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (threads > job.count) {
+        threads = job.count;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    for (int i = 0; i < threads; i++) {
+        pthread_create(&workers[i], NULL, sweep_worker, &job);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    FILE* out = fopen(output, "w");
+    if (out == NULL) {
+        perror("Sweep: failed to create output file");
+        free(results);
+        return 1;
+    }
+
+    size_t len = strlen(output);
+    if (len >= 5 && strcmp(output + len - 5, ".json") == 0) {
+        write_json(out, results, job.count);
+    }
+    else {
+        write_csv(out, results, job.count);
+    }
+    fclose(out);
+
+    int failed = 0;
+    for (int i = 0; i < job.count; i++) {
+        failed += results[i].status != 0;
+    }
+
+    fprintf(stderr, "Sweep: %d configurations (%d invalid or failed) of %d processes in %.2fs on %d threads -> %s\n",
+        job.count, failed, process_count, seconds, threads, output);
+
+    free(results);
+    return 0;
+}
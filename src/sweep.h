@@ -0,0 +1,43 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "process.h"
+#include "sim_engine.h"
+
+/**
+ * Parameter sweep: runs one independent engine simulation per point of an
+ * (algorithm x quantum x memory size x allocator) grid on a pool of threads
+ * and writes one CSV or JSON row of scheduler.perf metrics per configuration.
+ */
+
+typedef struct SweepGrid {
+    SchedulingAlgorithm* algorithms;
+    int algorithm_count;
+    int* quanta;
+    int quantum_count;
+    int* memory_sizes;
+    int memory_size_count;
+    SimAllocator* allocators;
+    int allocator_count;
+    SimCosts costs; // overhead cost model shared by every configuration
+    int cpu_count;  // CPUs of every configuration, 0 for one CPU
+    double cpu_speed[SIM_MAX_CPUS];
+    SimNuma numa;   // memory nodes of every configuration, 0 nodes for one
+    AdmitConfig admit; // memory admission policy of every configuration, oldest fit by default
+    SimSwap swap;      // swap device of every configuration, none by default
+    AdmissionMode admission; // EDF deadline admission control of the edf configurations, flag by default
+    int aging_interval;      // HPF aging of the hpf configurations, 0 disables it
+    double predict_alpha;     // burst prediction of the srtn / sjf / hrrn configurations, 0 disables it
+    PredictorKey predict_key;
+    const IoDevice* io_devices; // device models of every configuration
+    int io_device_count;
+    const TaskGroup* task_groups; // task group models of every configuration
+    int task_group_count;
+} SweepGrid;
+
+int sweep_parse_grid(SweepGrid* grid, const char* algorithms, const char* quanta,
+    const char* memory_sizes, const char* allocators);
+void sweep_free_grid(SweepGrid* grid);
+int run_sweep(const SweepGrid* grid, const Process* processes, int process_count, int threads, const char* output);
+
+#endif /* SWEEP_H */
@@ -0,0 +1,132 @@
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "task_group.h"
+
+static TaskGroup default_group = { "default", 1, 0, 0 };
+TaskGroup* task_groups = &default_group;
+int task_group_count = 1;
+static int task_group_capacity = 1;
+
+/**
+ * @brief Index of the group called `name`, registering it when it is new
+ *
+ * @return int the group index, -1 for an invalid name or allocation failure
+ */
+int task_group_id(const char* name) {
+    size_t length = strlen(name);
+    if (length == 0 || length >= TASK_GROUP_NAME_SIZE) {
+        return -1;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (!isalnum((unsigned char)name[i]) && name[i] != '_') {
+            return -1;
+        }
+    }
+
+    for (int i = 0; i < task_group_count; i++) {
+        if (strcmp(task_groups[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (task_group_count == task_group_capacity) {
+        int first = task_groups == &default_group;
+        TaskGroup* grown = realloc(first ? NULL : task_groups, 2 * task_group_capacity * sizeof(TaskGroup));
+        if (grown == NULL) {
+            return -1;
+        }
+        if (first) {
+            grown[0] = default_group;
+        }
+        task_groups = grown;
+        task_group_capacity *= 2;
+    }
+
+    TaskGroup* group = &task_groups[task_group_count];
+    memset(group, 0, sizeof(TaskGroup));
+    strcpy(group->name, name);
+    group->shares = 1;
+    return task_group_count++;
+}
+
+/**
+ * @brief Parse "<name>=<shares>[,quota=<ticks>,period=<ticks>]"
+ * @details A quota needs a period and the other way around.
+ *
+ * @return int 0 for success, 1 for an invalid name, option or value
+ */
+int parse_task_group(const char* spec) {
+    char* copy = strdup(spec);
+    if (copy == NULL) {
+        return 1;
+    }
+
+    int status = 1;
+    TaskGroup group = { "", 0, 0, 0 };
+    char* value = strchr(copy, '=');
+    char* save = NULL;
+    int id = -1;
+    if (value != NULL) {
+        *value++ = '\0';
+        id = task_group_id(copy);
+
+        char* item = strtok_r(value, ",", &save);
+        char* end;
+        long shares = item != NULL ? strtol(item, &end, 10) : 0;
+        status = id < 0 || item == NULL || *end != '\0' || shares <= 0 || shares > INT_MAX;
+        group.shares = (int)shares;
+    }
+
+    char* item;
+    while (status == 0 && (item = strtok_r(NULL, ",", &save)) != NULL) {
+        char* number = strchr(item, '=');
+        if (number == NULL) {
+            status = 1;
+            break;
+        }
+        *number++ = '\0';
+
+        char* end;
+        long ticks = strtol(number, &end, 10);
+        if (*number == '\0' || *end != '\0' || ticks <= 0 || ticks > INT_MAX) {
+            status = 1;
+        }
+        else if (strcmp(item, "quota") == 0) {
+            group.quota = (int)ticks;
+        }
+        else if (strcmp(item, "period") == 0) {
+            group.period = (int)ticks;
+        }
+        else {
+            status = 1;
+        }
+    }
+
+    if (status == 0 && (group.quota == 0) != (group.period == 0)) {
+        status = 1;
+    }
+    if (status == 0) {
+        task_groups[id].shares = group.shares;
+        task_groups[id].quota = group.quota;
+        task_groups[id].period = group.period;
+    }
+    free(copy);
+    return status;
+}
+
+/**
+ * @brief Whether the run uses groups: more than the default group, or a quota on it
+ */
+int task_groups_enabled(const TaskGroup* groups, int count) {
+    return count > 1 || (count == 1 && groups[0].quota > 0);
+}
+
+void task_group_stats_init(TaskGroupStats* stats) {
+    memset(stats, 0, sizeof(TaskGroupStats));
+    running_stat_init(&stats->ta);
+    running_stat_init(&stats->wait);
+    histogram_init(&stats->ta_hist, 1);
+    histogram_init(&stats->response_hist, 1);
+}
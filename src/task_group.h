@@ -0,0 +1,45 @@
+#ifndef TASK_GROUP_H
+#define TASK_GROUP_H
+
+#include "stats.h"
+
+/**
+ * Task groups for hierarchical fair share (engine only).
+ * Processes name their group in the eighth input column; the CPU is shared between the
+ * groups with ready processes in proportion to their shares, and the scheduling policy
+ * orders the processes inside each group. A group can be capped at `quota` CPU ticks in
+ * every `period` ticks (periods start at multiples of `period`), cgroup cpu.max style:
+ * once the quota is spent its processes are throttled until the next period.
+ * Processes without a group belong to group 0, "default".
+ */
+
+#define TASK_GROUP_NAME_SIZE 16
+
+typedef struct TaskGroup {
+    char name[TASK_GROUP_NAME_SIZE];
+    int shares; // weight of the group's CPU share, 1 by default
+    int quota;  // CPU ticks per period, 0 for no limit
+    int period;
+} TaskGroup;
+
+typedef struct TaskGroupStats {
+    int cpu_time;       // CPU ticks its processes ran
+    int throttled_time; // ticks the group spent throttled
+    long long throttled_periods;
+    RunningStat ta;
+    RunningStat wait;
+    Histogram ta_hist;
+    Histogram response_hist;
+} TaskGroupStats;
+
+// Group table the input parser registers groups in (grown as needed), handed to the
+// simulation in its SimConfig; group 0 is "default"
+extern TaskGroup* task_groups;
+extern int task_group_count;
+
+int task_group_id(const char* name);
+int parse_task_group(const char* spec);
+int task_groups_enabled(const TaskGroup* groups, int count);
+void task_group_stats_init(TaskGroupStats* stats);
+
+#endif /* TASK_GROUP_H */
@@ -0,0 +1,417 @@
+/*
+ * Micro and end-to-end benchmarks of the scheduler hot paths and data structures.
+ * Every benchmark runs at each size; its operations are timed in batches and the
+ * median and p99 of the per-batch ns/op are written as JSON.
+ *
+ * Usage: ./bench [-n <sizes>] [-r <repetitions>] [-b <name filter>] [-o <file>]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "../DS/IQueue.h"
+#include "../DS/hash_map.h"
+#include "../buddy_memory.h"
+#include "../file_handlers.h"
+#include "../sim_engine.h"
+#include "../workload.h"
+#include "../logger.h"
+
+#define BATCH 64 // operations per timed sample
+
+typedef struct Samples {
+    double* ns; // ns/op of each batch
+    int count;
+    int capacity;
+    long long ops;
+} Samples;
+
+typedef struct Benchmark {
+    const char* name;
+    const char* unit;
+    void (*run)(int n, Samples* samples);
+} Benchmark;
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void sample_push(Samples* samples, uint64_t elapsed, int ops) {
+    if (samples->count == samples->capacity) {
+        samples->capacity = samples->capacity == 0 ? 1024 : samples->capacity * 2;
+        samples->ns = realloc(samples->ns, samples->capacity * sizeof(double));
+    }
+    samples->ns[samples->count++] = (double)elapsed / ops;
+    samples->ops += ops;
+}
+
+/* Time `body` for i in [0, n) in batches of BATCH operations */
+#define TIMED_LOOP(samples, n, i, body)                           \
+    for (int i = 0; i < (n);) {                                   \
+        int batch_end_ = i + BATCH < (n) ? i + BATCH : (n);       \
+        int batch_ops_ = batch_end_ - i;                          \
+        uint64_t batch_start_ = now_ns();                         \
+        for (; i < batch_end_; i++) { body; }                     \
+        sample_push((samples), now_ns() - batch_start_, batch_ops_); \
+    }
+
+static uint64_t rng_state = 42;
+
+static uint32_t bench_rand() {
+    // xorshift64*, deterministic across runs
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (uint32_t)((rng_state * 2685821657736338717ull) >> 32);
+}
+
+static Process* make_processes(int n) {
+    Process* procs = malloc(n * sizeof(Process));
+    for (int i = 0; i < n; i++) {
+        procs[i].id = i + 1;
+        procs[i].arrival_time = i;
+        procs[i].runtime = 1 + bench_rand() % 100;
+        procs[i].priority = bench_rand() % 11;
+        procs[i].memory_size = 1 + bench_rand() % 256;
+        procs[i].deadline = 0;
+        procs[i].period = 0;
+        procs[i].io = NULL;
+        procs[i].io_count = 0;
+        procs[i].group = 0;
+        procs[i].affinity = 0;
+    }
+    return procs;
+}
+
+static void bench_queue(int n, Samples* samples, SchedulingAlgorithm algorithm, int measure_dequeue) {
+    Process* procs = make_processes(n);
+    IQueue queue;
+    init_queue(&queue, algorithm);
+
+    if (measure_dequeue) {
+        for (int i = 0; i < n; i++) {
+            enqueue(&queue, &procs[i], procs[i].priority);
+        }
+        TIMED_LOOP(samples, n, i, dequeue(&queue, 1));
+    }
+    else {
+        TIMED_LOOP(samples, n, i, enqueue(&queue, &procs[i], procs[i].priority));
+        while (!is_empty(&queue)) {
+            dequeue(&queue, 1);
+        }
+    }
+
+    free_queue(&queue);
+    free(procs);
+}
+
+static void bench_pq_enqueue(int n, Samples* samples) { bench_queue(n, samples, HPF, 0); }
+static void bench_pq_dequeue(int n, Samples* samples) { bench_queue(n, samples, HPF, 1); }
+static void bench_cq_enqueue(int n, Samples* samples) { bench_queue(n, samples, RR, 0); }
+static void bench_cq_dequeue(int n, Samples* samples) { bench_queue(n, samples, RR, 1); }
+
+static void bench_pq_change_priority(int n, Samples* samples) {
+    Process* procs = make_processes(n);
+    IQueue queue;
+    init_queue(&queue, HPF);
+    for (int i = 0; i < n; i++) {
+        enqueue(&queue, &procs[i], procs[i].priority);
+    }
+
+    TIMED_LOOP(samples, n, i, change_priority(&queue, bench_rand() % n, bench_rand() % 11));
+
+    while (!is_empty(&queue)) {
+        dequeue(&queue, 1);
+    }
+    free_queue(&queue);
+    free(procs);
+}
+
+/**
+ * @brief Buddy memory large enough for n blocks of up to 256 bytes on average half full
+ */
+static Block* bench_memory(int n) {
+    int size = 1024;
+    while (size < n * 128) {
+        size *= 2;
+    }
+    return init_memory_size(size);
+}
+
+static void bench_buddy(int n, Samples* samples, int measure_free) {
+    Block* memory = bench_memory(n);
+    Block** blocks = malloc(n * sizeof(Block*));
+    int* sizes = malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        sizes[i] = 1 + bench_rand() % 128;
+    }
+
+    if (measure_free) {
+        for (int i = 0; i < n; i++) {
+            blocks[i] = allocate_memory(memory, sizes[i]);
+        }
+        // Free in a random order so merges happen all over the list
+        for (int i = n - 1; i > 0; i--) {
+            int j = bench_rand() % (i + 1);
+            Block* tmp = blocks[i];
+            blocks[i] = blocks[j];
+            blocks[j] = tmp;
+        }
+        TIMED_LOOP(samples, n, i, deallocate_memory(blocks[i]));
+    }
+    else {
+        TIMED_LOOP(samples, n, i, blocks[i] = allocate_memory(memory, sizes[i]));
+        for (int i = 0; i < n; i++) {
+            deallocate_memory(blocks[i]);
+        }
+    }
+
+    destroy_memory(memory);
+    free(blocks);
+    free(sizes);
+}
+
+static void bench_buddy_allocate(int n, Samples* samples) { bench_buddy(n, samples, 0); }
+static void bench_buddy_free(int n, Samples* samples) { bench_buddy(n, samples, 1); }
+
+static void bench_hashmap(int n, Samples* samples, int op) {
+    HashMap* map = hashmap_create(2 * n);
+    int* keys = malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        keys[i] = (int)(bench_rand() >> 1);
+    }
+
+    if (op == 0) {
+        TIMED_LOOP(samples, n, i, hashmap_put(map, keys[i], &keys[i]));
+    }
+    else {
+        for (int i = 0; i < n; i++) {
+            hashmap_put(map, keys[i], &keys[i]);
+        }
+        if (op == 1) {
+            TIMED_LOOP(samples, n, i, hashmap_get(map, keys[bench_rand() % n]));
+        }
+        else {
+            TIMED_LOOP(samples, n, i, hashmap_remove(map, keys[i]));
+        }
+    }
+
+    hashmap_free(map);
+    free(keys);
+}
+
+static void bench_hashmap_put(int n, Samples* samples) { bench_hashmap(n, samples, 0); }
+static void bench_hashmap_get(int n, Samples* samples) { bench_hashmap(n, samples, 1); }
+static void bench_hashmap_remove(int n, Samples* samples) { bench_hashmap(n, samples, 2); }
+
+/**
+ * @brief Write n synthetic processes to a temporary file in the text or binary format
+ */
+static void write_workload_file(const char* path, int n, int binary) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        perror("bench: failed to create workload file");
+        exit(EXIT_FAILURE);
+    }
+
+    Process* procs = make_processes(n);
+    if (binary) {
+        WorkloadHeader header = { WORKLOAD_MAGIC, WORKLOAD_VERSION, (uint64_t)n };
+        fwrite(&header, sizeof(header), 1, file);
+        for (int i = 0; i < n; i++) {
+            WorkloadRecord record = { procs[i].id, procs[i].arrival_time, procs[i].runtime, procs[i].priority, procs[i].memory_size, 0 };
+            fwrite(&record, sizeof(record), 1, file);
+        }
+    }
+    else {
+        fprintf(file, "#id arrival runtime priority memsize\n");
+        for (int i = 0; i < n; i++) {
+            fprintf(file, "%d\t%d\t%d\t%d\t%d\n", procs[i].id, procs[i].arrival_time, procs[i].runtime, procs[i].priority, procs[i].memory_size);
+        }
+    }
+    fclose(file);
+    free(procs);
+}
+
+static void bench_parse(int n, Samples* samples, int binary) {
+    char path[] = "/tmp/os-sim-bench-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        perror("bench: mkstemp failed");
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+    write_workload_file(path, n, binary);
+
+    Process* list = NULL;
+    int count = 0;
+    uint64_t start = now_ns();
+    read_input_file(path, &list, &count);
+    sample_push(samples, now_ns() - start, n);
+
+    free_process_list(list, count);
+    unlink(path);
+}
+
+static void bench_parse_text(int n, Samples* samples) { bench_parse(n, samples, 0); }
+static void bench_parse_binary(int n, Samples* samples) { bench_parse(n, samples, 1); }
+
+/**
+ * @brief End-to-end engine run at ~90% load, timed per event
+ */
+static void bench_engine(int n, Samples* samples, SchedulingAlgorithm algorithm) {
+    WorkloadSpec spec;
+    if (workload_init(&spec, 7, "poisson:0.09", "exp:10", "zipf:1:11", "lognormal:4:0.8") != 0) {
+        exit(EXIT_FAILURE);
+    }
+    Process* procs = malloc(n * sizeof(Process));
+    for (int i = 0; i < n; i++) {
+        workload_next(&spec, &procs[i]);
+    }
+    workload_free(&spec);
+
+    SimConfig config;
+    sim_config_init(&config);
+    config.algorithm = algorithm;
+    config.quantum = 2;
+    Sim* sim = sim_create(&config);
+
+    uint64_t start = now_ns();
+    sim_run_trace(sim, procs, n);
+    uint64_t elapsed = now_ns() - start;
+
+    long long events = sim_stats(sim)->events;
+    sample_push(samples, elapsed, events > 0 ? (int)events : 1);
+
+    sim_destroy(sim);
+    free(procs);
+}
+
+static void bench_engine_rr(int n, Samples* samples) { bench_engine(n, samples, RR); }
+static void bench_engine_hpf(int n, Samples* samples) { bench_engine(n, samples, HPF); }
+static void bench_engine_srtn(int n, Samples* samples) { bench_engine(n, samples, SRTN); }
+
+static const Benchmark benchmarks[] = {
+    { "iqueue_pq_enqueue", "ns/op", bench_pq_enqueue },
+    { "iqueue_pq_dequeue", "ns/op", bench_pq_dequeue },
+    { "iqueue_pq_change_priority", "ns/op", bench_pq_change_priority },
+    { "iqueue_cq_enqueue", "ns/op", bench_cq_enqueue },
+    { "iqueue_cq_dequeue", "ns/op", bench_cq_dequeue },
+    { "buddy_allocate", "ns/op", bench_buddy_allocate },
+    { "buddy_free", "ns/op", bench_buddy_free },
+    { "hashmap_put", "ns/op", bench_hashmap_put },
+    { "hashmap_get", "ns/op", bench_hashmap_get },
+    { "hashmap_remove", "ns/op", bench_hashmap_remove },
+    { "parse_text", "ns/process", bench_parse_text },
+    { "parse_binary", "ns/process", bench_parse_binary },
+    { "engine_rr", "ns/event", bench_engine_rr },
+    { "engine_hpf", "ns/event", bench_engine_hpf },
+    { "engine_srtn", "ns/event", bench_engine_srtn },
+};
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double* sorted, int count, double p) {
+    int index = (int)(p / 100 * (count - 1) + 0.5);
+    return sorted[index];
+}
+
+static void usage() {
+    fprintf(stderr,
+        "Usage: ./bench [-n <sizes>] [-r <repetitions>] [-b <name filter>] [-o <file>]\n"
+        "  -n  comma separated problem sizes (default 100,1000,10000)\n"
+        "  -r  repetitions of every benchmark and size (default 5)\n"
+        "  -b  only run benchmarks whose name contains the filter\n"
+        "  -o  JSON output file (default stdout)\n");
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char* argv[]) {
+    char* sizes_list = "100,1000,10000";
+    int repetitions = 5;
+    const char* filter = NULL;
+    const char* output = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:b:o:")) != -1) {
+        switch (opt) {
+        case 'n': sizes_list = optarg; break;
+        case 'r': repetitions = atoi(optarg); break;
+        case 'b': filter = optarg; break;
+        case 'o': output = optarg; break;
+        default: usage();
+        }
+    }
+    if (repetitions <= 0) {
+        usage();
+    }
+
+    int sizes[32];
+    int size_count = 0;
+    sizes_list = strdup(sizes_list);
+    for (char* item = strtok(sizes_list, ","); item != NULL && size_count < 32; item = strtok(NULL, ",")) {
+        sizes[size_count] = atoi(item);
+        if (sizes[size_count] <= 0) {
+            usage();
+        }
+        size_count++;
+    }
+    free(sizes_list);
+
+    FILE* out = output != NULL ? fopen(output, "w") : stdout;
+    if (out == NULL) {
+        perror("bench: failed to open output");
+        return EXIT_FAILURE;
+    }
+    log_level = LOG_LEVEL_ERROR; // measure the data structures, not their traces
+
+    fprintf(out, "{\"repetitions\":%d,\"batch\":%d,\"results\":[", repetitions, BATCH);
+    int first = 1;
+    for (size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++) {
+        const Benchmark* bench = &benchmarks[b];
+        if (filter != NULL && strstr(bench->name, filter) == NULL) {
+            continue;
+        }
+
+        for (int s = 0; s < size_count; s++) {
+            Samples samples = { NULL, 0, 0, 0 };
+            rng_state = 42;
+            for (int r = 0; r < repetitions; r++) {
+                bench->run(sizes[s], &samples);
+            }
+
+            qsort(samples.ns, samples.count, sizeof(double), compare_double);
+            double sum = 0;
+            for (int i = 0; i < samples.count; i++) {
+                sum += samples.ns[i];
+            }
+            double median = percentile(samples.ns, samples.count, 50);
+            double p99 = percentile(samples.ns, samples.count, 99);
+
+            fprintf(out, "%s\n{\"name\":\"%s\",\"size\":%d,\"unit\":\"%s\",\"ops\":%lld,\"samples\":%d,"
+                "\"median\":%.2f,\"p99\":%.2f,\"mean\":%.2f,\"ops_per_sec\":%.0f}",
+                first ? "" : ",", bench->name, sizes[s], bench->unit, samples.ops, samples.count,
+                median, p99, sum / samples.count, median > 0 ? 1e9 / median : 0);
+            fflush(out);
+            first = 0;
+
+            fprintf(stderr, "%-26s n=%-8d median %10.1f %-10s p99 %10.1f\n", bench->name, sizes[s], median, bench->unit, p99);
+            free(samples.ns);
+        }
+    }
+    fprintf(out, "\n]}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return EXIT_SUCCESS;
+}
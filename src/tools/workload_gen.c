@@ -0,0 +1,158 @@
+/*
+ * Non-interactive synthetic workload generator.
+ * Writes processes in the os-sim text input format or in the binary workload format.
+ *
+ * Usage: ./workload-gen -n <count> [-S <seed>] [-o <file>] [-b]
+ *                       [-a <arrival>] [-r <runtime>] [-p <priority>] [-m <memory>] [-L <slack>]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "../workload.h"
+
+#define BATCH_SIZE 4096
+#define LINE_MAX_LEN 72
+
+static void usage() {
+    fprintf(stderr,
+        "Usage: ./workload-gen -n <count> [-S <seed>] [-o <file>] [-b]\n"
+        "                      [-a <arrival>] [-r <runtime>] [-p <priority>] [-m <memory>] [-L <slack>]\n"
+        "  -a  poisson:<rate> | mmpp:<low rate>:<high rate>:<low dwell>:<high dwell>  (default poisson:0.5)\n"
+        "  -r  exp:<mean> | pareto:<alpha>:<min> | bimodal:<short>:<long>:<p long>      (default exp:10)\n"
+        "  -p  zipf:<exponent>:<n> | uniform:<min>:<max> | constant:<value>            (default zipf:1:11)\n"
+        "  -m  lognormal:<mu>:<sigma> | uniform:<min>:<max> | constant:<value>         (default lognormal:4:0.8)\n"
+        "  -L  any distribution: adds a deadline of arrival + runtime + slack          (default no deadlines)\n"
+        "  -b  write the binary format instead of text\n");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Write a non-negative integer followed by a separator, returns the new end of the buffer
+ */
+static char* put_int(char* out, int value, char separator) {
+    char digits[12];
+    int len = 0;
+    do {
+        digits[len++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    while (len > 0) {
+        *out++ = digits[--len];
+    }
+    *out++ = separator;
+    return out;
+}
+
+static void write_text(FILE* out, WorkloadSpec* spec, long long count) {
+    static char buffer[BATCH_SIZE * LINE_MAX_LEN];
+    Process proc;
+
+    fputs(spec->has_deadline ? "#id arrival runtime priority memsize deadline\n" : "#id arrival runtime priority memsize\n", out);
+
+    for (long long written = 0; written < count;) {
+        char* end = buffer;
+        for (int i = 0; i < BATCH_SIZE && written < count; i++, written++) {
+            workload_next(spec, &proc);
+            end = put_int(end, proc.id, '\t');
+            end = put_int(end, proc.arrival_time, '\t');
+            end = put_int(end, proc.runtime, '\t');
+            end = put_int(end, proc.priority, '\t');
+            if (spec->has_deadline) {
+                end = put_int(end, proc.memory_size, '\t');
+                end = put_int(end, proc.deadline - proc.arrival_time, '\n');
+            }
+            else {
+                end = put_int(end, proc.memory_size, '\n');
+            }
+        }
+        fwrite(buffer, 1, end - buffer, out);
+    }
+}
+
+static void write_binary(FILE* out, WorkloadSpec* spec, long long count) {
+    static WorkloadRecord records[BATCH_SIZE];
+    Process proc;
+
+    WorkloadHeader header = { WORKLOAD_MAGIC, WORKLOAD_VERSION, (uint64_t)count };
+    fwrite(&header, sizeof(header), 1, out);
+
+    for (long long written = 0; written < count;) {
+        int batch = 0;
+        for (; batch < BATCH_SIZE && written < count; batch++, written++) {
+            workload_next(spec, &proc);
+            records[batch].id = proc.id;
+            records[batch].arrival_time = proc.arrival_time;
+            records[batch].runtime = proc.runtime;
+            records[batch].priority = proc.priority;
+            records[batch].memory_size = proc.memory_size;
+            records[batch].deadline = proc.deadline > 0 ? proc.deadline - proc.arrival_time : 0;
+        }
+        fwrite(records, sizeof(WorkloadRecord), batch, out);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    long long count = -1;
+    unsigned long long seed = (unsigned long long)time(NULL);
+    const char* output = "processes.txt";
+    const char* arrival = "poisson:0.5";
+    const char* runtime = "exp:10";
+    const char* priority = "zipf:1:11";
+    const char* memory = "lognormal:4:0.8";
+    const char* slack = NULL;
+    int binary = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:S:o:ba:r:p:m:L:")) != -1) {
+        switch (opt) {
+        case 'n': count = atoll(optarg); break;
+        case 'S': seed = strtoull(optarg, NULL, 10); break;
+        case 'o': output = optarg; break;
+        case 'b': binary = 1; break;
+        case 'a': arrival = optarg; break;
+        case 'r': runtime = optarg; break;
+        case 'p': priority = optarg; break;
+        case 'm': memory = optarg; break;
+        case 'L': slack = optarg; break;
+        default: usage();
+        }
+    }
+    if (count < 0) {
+        usage();
+    }
+
+    WorkloadSpec spec;
+    if (workload_init(&spec, seed, arrival, runtime, priority, memory) != 0) {
+        usage();
+    }
+    if (slack != NULL && workload_set_deadline(&spec, slack) != 0) {
+        workload_free(&spec);
+        usage();
+    }
+
+    FILE* out = fopen(output, binary ? "wb" : "w");
+    if (out == NULL) {
+        perror("Error opening output file");
+        workload_free(&spec);
+        return EXIT_FAILURE;
+    }
+
+    clock_t start = clock();
+    if (binary) {
+        write_binary(out, &spec, count);
+    }
+    else {
+        write_text(out, &spec, count);
+    }
+    fclose(out);
+
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    fprintf(stderr, "Generated %lld processes (seed %llu) in %.3fs -> %s\n", count, seed, seconds, output);
+
+    workload_free(&spec);
+    return EXIT_SUCCESS;
+}
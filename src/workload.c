@@ -0,0 +1,416 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "workload.h"
+
+/**
+ * @brief splitmix64 step, used to expand the seed into the xoshiro state
+ */
+static uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * @brief Seed the generator, the same seed always gives the same workload
+ */
+void rng_seed(Rng* rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitmix64(&seed);
+    }
+}
+
+/**
+ * @brief Next 64 random bits (xoshiro256**)
+ */
+uint64_t rng_next(Rng* rng) {
+    uint64_t* s = rng->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+/**
+ * @brief Uniform double in (0, 1]
+ */
+double rng_uniform(Rng* rng) {
+    return ((rng_next(rng) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Standard normal sample (Box-Muller)
+ */
+static double rng_normal(Rng* rng) {
+    double u1 = rng_uniform(rng);
+    double u2 = rng_uniform(rng);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static double rng_exponential(Rng* rng, double mean) {
+    return -mean * log(rng_uniform(rng));
+}
+
+/**
+ * @brief Split "name:a:b:c" into its name and up to 4 numeric parameters
+ *
+ * @return int number of parameters parsed, -1 on a malformed number
+ */
+static int parse_spec(const char* spec, char* name, size_t name_size, double* params, int max_params) {
+    const char* colon = strchr(spec, ':');
+    size_t len = colon ? (size_t)(colon - spec) : strlen(spec);
+    if (len >= name_size) {
+        return -1;
+    }
+    memcpy(name, spec, len);
+    name[len] = '\0';
+
+    int count = 0;
+    while (colon != NULL && count < max_params) {
+        char* end;
+        params[count++] = strtod(colon + 1, &end);
+        if (end == colon + 1 || (*end != ':' && *end != '\0')) {
+            return -1;
+        }
+        colon = (*end == ':') ? end : NULL;
+    }
+    return colon == NULL ? count : -1;
+}
+
+/**
+ * @brief Parse a distribution spec, e.g. "exp:10" or "zipf:1.2:11"
+ *
+ * @return int 0 for success, 1 for error
+ */
+int dist_parse(Distribution* dist, const char* spec) {
+    char name[32];
+    double p[4] = { 0 };
+    int count = parse_spec(spec, name, sizeof(name), p, 4);
+
+    memset(dist, 0, sizeof(Distribution));
+    dist->a = p[0];
+    dist->b = p[1];
+    dist->c = p[2];
+
+    if (strcmp(name, "constant") == 0 && count == 1) {
+        dist->type = DIST_CONSTANT;
+    }
+    else if (strcmp(name, "uniform") == 0 && count == 2 && p[0] <= p[1]) {
+        dist->type = DIST_UNIFORM;
+    }
+    else if (strcmp(name, "exp") == 0 && count == 1 && p[0] > 0) {
+        dist->type = DIST_EXPONENTIAL;
+    }
+    else if (strcmp(name, "pareto") == 0 && count == 2 && p[0] > 0 && p[1] > 0) {
+        dist->type = DIST_PARETO;
+    }
+    else if (strcmp(name, "bimodal") == 0 && count == 3 && p[0] > 0 && p[1] > 0 && p[2] >= 0 && p[2] <= 1) {
+        dist->type = DIST_BIMODAL;
+    }
+    else if (strcmp(name, "lognormal") == 0 && count == 2 && p[1] >= 0) {
+        dist->type = DIST_LOGNORMAL;
+    }
+    else if (strcmp(name, "zipf") == 0 && count == 2 && p[0] >= 0 && p[1] >= 1) {
+        dist->type = DIST_ZIPF;
+        dist->n = (int)p[1];
+        dist->cdf = malloc(dist->n * sizeof(double));
+        if (dist->cdf == NULL) {
+            return 1;
+        }
+
+        // Cumulative weights 1 / (k + 1)^s, normalized
+        double sum = 0;
+        for (int k = 0; k < dist->n; k++) {
+            sum += 1.0 / pow(k + 1, p[0]);
+            dist->cdf[k] = sum;
+        }
+        for (int k = 0; k < dist->n; k++) {
+            dist->cdf[k] /= sum;
+        }
+    }
+    else {
+        fprintf(stderr, "Invalid distribution: %s\n", spec);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Draw one sample from a distribution
+ */
+double dist_sample(const Distribution* dist, Rng* rng) {
+    switch (dist->type) {
+    case DIST_CONSTANT:
+        return dist->a;
+
+    case DIST_UNIFORM:
+        return dist->a + (dist->b - dist->a) * rng_uniform(rng);
+
+    case DIST_EXPONENTIAL:
+        return rng_exponential(rng, dist->a);
+
+    case DIST_PARETO:
+        return dist->b / pow(rng_uniform(rng), 1.0 / dist->a);
+
+    case DIST_BIMODAL:
+        if (rng_uniform(rng) <= dist->c) {
+            return rng_exponential(rng, dist->b);
+        }
+        return rng_exponential(rng, dist->a);
+
+    case DIST_LOGNORMAL:
+        return exp(dist->a + dist->b * rng_normal(rng));
+
+    case DIST_ZIPF: {
+        // Binary search for the first cumulative weight >= u
+        double u = rng_uniform(rng);
+        int low = 0, high = dist->n - 1;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (dist->cdf[mid] < u) {
+                low = mid + 1;
+            }
+            else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+    }
+
+    return 0;
+}
+
+void dist_free(Distribution* dist) {
+    free(dist->cdf);
+    dist->cdf = NULL;
+}
+
+/**
+ * @brief Parse an arrival process spec, e.g. "poisson:0.5" or "mmpp:0.1:2:50:5"
+ *
+ * @return int 0 for success, 1 for error
+ */
+int arrival_parse(ArrivalProcess* arrival, const char* spec) {
+    char name[32];
+    double p[4] = { 0 };
+    int count = parse_spec(spec, name, sizeof(name), p, 4);
+
+    memset(arrival, 0, sizeof(ArrivalProcess));
+
+    if (strcmp(name, "poisson") == 0 && count == 1 && p[0] > 0) {
+        arrival->type = ARRIVAL_POISSON;
+        arrival->rate[0] = p[0];
+    }
+    else if (strcmp(name, "mmpp") == 0 && count == 4 && p[0] > 0 && p[1] > 0 && p[2] > 0 && p[3] > 0) {
+        arrival->type = ARRIVAL_MMPP;
+        arrival->rate[0] = p[0];
+        arrival->rate[1] = p[1];
+        arrival->dwell[0] = p[2];
+        arrival->dwell[1] = p[3];
+        arrival->state_end = -1; // drawn on the first arrival
+    }
+    else {
+        fprintf(stderr, "Invalid arrival process: %s\n", spec);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Advance the arrival process to its next arrival
+ *
+ * @return double time of the next arrival (in ticks)
+ */
+double arrival_next(ArrivalProcess* arrival, Rng* rng) {
+    if (arrival->type == ARRIVAL_POISSON) {
+        arrival->time += rng_exponential(rng, 1.0 / arrival->rate[0]);
+        return arrival->time;
+    }
+
+    // MMPP: exponential gaps at the current state's rate, the state flips after an exponential dwell.
+    // Both are memoryless, so a gap crossing the state boundary is simply redrawn from there.
+    if (arrival->state_end < 0) {
+        arrival->state_end = rng_exponential(rng, arrival->dwell[0]);
+    }
+    while (1) {
+        double next = arrival->time + rng_exponential(rng, 1.0 / arrival->rate[arrival->state]);
+        if (next <= arrival->state_end) {
+            arrival->time = next;
+            return next;
+        }
+        arrival->time = arrival->state_end;
+        arrival->state = 1 - arrival->state;
+        arrival->state_end = arrival->time + rng_exponential(rng, arrival->dwell[arrival->state]);
+    }
+}
+
+/**
+ * @brief Initialize a workload from its distribution specs
+ *
+ * @return int 0 for success, 1 for error
+ */
+int workload_init(WorkloadSpec* spec, uint64_t seed, const char* arrival, const char* runtime,
+    const char* priority, const char* memory) {
+    memset(spec, 0, sizeof(WorkloadSpec));
+    rng_seed(&spec->rng, seed);
+    spec->next_id = 1;
+
+    if (arrival_parse(&spec->arrival, arrival) != 0 ||
+        dist_parse(&spec->runtime, runtime) != 0 ||
+        dist_parse(&spec->priority, priority) != 0 ||
+        dist_parse(&spec->memory, memory) != 0) {
+        workload_free(spec);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Give every following process a deadline of arrival + runtime + a sampled slack
+ *
+ * @return int 0 for success, 1 for an invalid slack distribution
+ */
+int workload_set_deadline(WorkloadSpec* spec, const char* slack) {
+    if (dist_parse(&spec->slack, slack) != 0) {
+        return 1;
+    }
+    spec->has_deadline = 1;
+    return 0;
+}
+
+static int clamp_round(double value, int min, int max) {
+    if (value < min) return min;
+    if (value > max) return max;
+    return (int)(value + 0.5);
+}
+
+static int release_before(const WorkloadSpec* spec, int a, int b) {
+    if (spec->next_release[a] != spec->next_release[b]) {
+        return spec->next_release[a] < spec->next_release[b];
+    }
+    return spec->tasks[a].id < spec->tasks[b].id;
+}
+
+static void task_heap_sift_down(WorkloadSpec* spec, int i) {
+    int* heap = spec->task_heap;
+    while (1) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < spec->task_count && release_before(spec, heap[left], heap[smallest])) smallest = left;
+        if (right < spec->task_count && release_before(spec, heap[right], heap[smallest])) smallest = right;
+        if (smallest == i) {
+            return;
+        }
+        int t = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = t;
+        i = smallest;
+    }
+}
+
+/**
+ * @brief Initialize a workload that releases the jobs of a periodic task set
+ * @details Jobs are expanded lazily: only the next release of every task is kept,
+ *          so memory is O(tasks) whatever the horizon. Each job gets a new id, the task's
+ *          wcet, memory size, absolute deadline and period, and its rate-monotonic rank as priority.
+ *
+ * @return int 0 for success, 1 for error
+ */
+int workload_init_periodic(WorkloadSpec* spec, const PeriodicTask* tasks, int count) {
+    memset(spec, 0, sizeof(WorkloadSpec));
+    spec->next_id = 1;
+
+    spec->tasks = malloc(count * sizeof(PeriodicTask));
+    spec->task_heap = malloc(count * sizeof(int));
+    spec->next_release = malloc(count * sizeof(long long));
+    spec->rm_rank = malloc(count * sizeof(int));
+    if (count <= 0 || spec->tasks == NULL || spec->task_heap == NULL || spec->next_release == NULL || spec->rm_rank == NULL) {
+        workload_free(spec);
+        return 1;
+    }
+    memcpy(spec->tasks, tasks, count * sizeof(PeriodicTask));
+    spec->task_count = count;
+
+    for (int i = 0; i < count; i++) {
+        spec->next_release[i] = tasks[i].phase;
+        spec->task_heap[i] = i;
+        spec->rm_rank[i] = 0;
+        for (int j = 0; j < count; j++) {
+            spec->rm_rank[i] += periodic_before(&tasks[j], &tasks[i]);
+        }
+    }
+    for (int i = count / 2 - 1; i >= 0; i--) {
+        task_heap_sift_down(spec, i);
+    }
+    return 0;
+}
+
+/**
+ * @brief Generate the next process of the workload (arrival times are non-decreasing)
+ */
+void workload_next(WorkloadSpec* spec, Process* proc) {
+    proc->id = spec->next_id++;
+    proc->period = 0;
+    proc->io = NULL;
+    proc->io_count = 0;
+    proc->group = 0;
+    proc->affinity = 0;
+
+    if (spec->task_count > 0) {
+        int task = spec->task_heap[0];
+        long long release = spec->next_release[task];
+        proc->arrival_time = release > INT_MAX ? INT_MAX : (int)release;
+        proc->runtime = spec->tasks[task].wcet;
+        proc->priority = spec->rm_rank[task];
+        proc->memory_size = spec->tasks[task].memory_size;
+        proc->deadline = proc->arrival_time + spec->tasks[task].deadline;
+        proc->period = spec->tasks[task].period;
+
+        spec->next_release[task] += spec->tasks[task].period;
+        task_heap_sift_down(spec, 0);
+        return;
+    }
+
+    proc->arrival_time = (int)arrival_next(&spec->arrival, &spec->rng);
+    proc->runtime = clamp_round(dist_sample(&spec->runtime, &spec->rng), 1, WORKLOAD_MAX_RUNTIME);
+    proc->priority = clamp_round(dist_sample(&spec->priority, &spec->rng), 0, 1 << 20);
+    proc->memory_size = clamp_round(dist_sample(&spec->memory, &spec->rng), 1, WORKLOAD_MAX_MEMORY);
+    proc->deadline = 0;
+    if (spec->has_deadline) {
+        proc->deadline = proc->arrival_time + proc->runtime + clamp_round(dist_sample(&spec->slack, &spec->rng), 0, WORKLOAD_MAX_RUNTIME);
+    }
+}
+
+void workload_free(WorkloadSpec* spec) {
+    dist_free(&spec->runtime);
+    dist_free(&spec->priority);
+    dist_free(&spec->memory);
+    if (spec->has_deadline) {
+        dist_free(&spec->slack);
+    }
+    free(spec->tasks);
+    free(spec->task_heap);
+    free(spec->next_release);
+    free(spec->rm_rank);
+}
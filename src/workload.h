@@ -0,0 +1,109 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdint.h>
+#include "process.h"
+#include "periodic.h"
+
+/**
+ * Synthetic workload generation: a seeded RNG, the statistical distributions used for
+ * runtimes / priorities / memory sizes, and Poisson or bursty (MMPP) arrival processes,
+ * or the jobs of a periodic task set, released one at a time in time order.
+ * Shared by the workload-gen tool and the process generator.
+ */
+
+// Binary workload file: WorkloadHeader followed by `count` WorkloadRecord entries
+#define WORKLOAD_MAGIC 0x4C57534FU // "OSWL" little endian
+#define WORKLOAD_VERSION 2 // 2 added the deadline
+
+#define WORKLOAD_MAX_RUNTIME 1000000
+#define WORKLOAD_MAX_MEMORY 256
+
+typedef struct WorkloadHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t count;
+} WorkloadHeader;
+
+typedef struct WorkloadRecord {
+    int32_t id;
+    int32_t arrival_time;
+    int32_t runtime;
+    int32_t priority;
+    int32_t memory_size;
+    int32_t deadline; // relative to arrival, 0 for none
+} WorkloadRecord;
+
+// xoshiro256** generator
+typedef struct Rng {
+    uint64_t s[4];
+} Rng;
+
+typedef enum DistType {
+    DIST_CONSTANT,    // constant:<value>
+    DIST_UNIFORM,     // uniform:<min>:<max>
+    DIST_EXPONENTIAL, // exp:<mean>
+    DIST_PARETO,      // pareto:<alpha>:<min>
+    DIST_BIMODAL,     // bimodal:<short mean>:<long mean>:<long probability>
+    DIST_LOGNORMAL,   // lognormal:<mu>:<sigma>
+    DIST_ZIPF         // zipf:<exponent>:<n> (values 0 .. n-1, 0 most frequent)
+} DistType;
+
+typedef struct Distribution {
+    DistType type;
+    double a, b, c;
+    double* cdf; // zipf only
+    int n;
+} Distribution;
+
+typedef enum ArrivalType {
+    ARRIVAL_POISSON, // poisson:<rate per tick>
+    ARRIVAL_MMPP     // mmpp:<low rate>:<high rate>:<low mean dwell>:<high mean dwell>
+} ArrivalType;
+
+typedef struct ArrivalProcess {
+    ArrivalType type;
+    double rate[2];
+    double dwell[2];
+    int state;         // current MMPP state
+    double state_end;  // time the current MMPP state ends
+    double time;       // time of the last arrival
+} ArrivalProcess;
+
+typedef struct WorkloadSpec {
+    Rng rng;
+    ArrivalProcess arrival;
+    Distribution runtime;
+    Distribution priority;
+    Distribution memory;
+    Distribution slack; // deadline = arrival + runtime + slack
+    int has_deadline;
+    int next_id;
+
+    // Periodic task set (workload_init_periodic): a min-heap of task indexes on their next release
+    PeriodicTask* tasks;
+    int task_count;
+    int* task_heap;
+    long long* next_release;
+    int* rm_rank; // rate-monotonic rank of every task, the job priority (0 is the shortest period)
+} WorkloadSpec;
+
+void rng_seed(Rng* rng, uint64_t seed);
+uint64_t rng_next(Rng* rng);
+double rng_uniform(Rng* rng);
+
+int dist_parse(Distribution* dist, const char* spec);
+double dist_sample(const Distribution* dist, Rng* rng);
+void dist_free(Distribution* dist);
+
+int arrival_parse(ArrivalProcess* arrival, const char* spec);
+double arrival_next(ArrivalProcess* arrival, Rng* rng);
+
+int workload_init(WorkloadSpec* spec, uint64_t seed, const char* arrival, const char* runtime,
+    const char* priority, const char* memory);
+int workload_init_periodic(WorkloadSpec* spec, const PeriodicTask* tasks, int count);
+int workload_set_deadline(WorkloadSpec* spec, const char* slack);
+void workload_next(WorkloadSpec* spec, Process* proc);
+void workload_free(WorkloadSpec* spec);
+
+#endif /* WORKLOAD_H */